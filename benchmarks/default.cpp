@@ -21,42 +21,468 @@
 // SOFTWARE.
 
 #include <benchmark/benchmark.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
-#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
 
 #include "libsame/libsame.h"
 
 namespace {
+/// The generator used when benchmarking the application specified generation
+/// engine.
+s16 app_sin_gen(void* const, const float t, const float freq) {
+  return static_cast<s16>(std::sin(6.2831853F * t * freq) * INT16_MAX);
+}
+
+/// The header every benchmark generates.
+constexpr const struct libsame_header header = {
+    .location_codes = {"048484", "048024", "048484", "048024", "048484",
+                       "048024", "048484", "048024", "048484", "048024",
+                       "048484", "048024", "048484", "048024", "048484",
+                       "048024", "048484", "048024", "048484", "048024",
+                       "048484", "048024", "048484", "048024", "048484",
+                       "048024", "048484", "048024", "048484", "048024",
+                       "048484"},
+    .valid_time_period = "1000",
+    .originator_code = "WXR",
+    .event_code = "TOR",
+    .callsign = "WAEB/AM ",
+    .originator_time = "1172221",
+    .attn_sig_duration = 8};
+
 void benchmark_default_path(benchmark::State& state) {
-  constexpr const struct libsame_header header = {
-      .location_codes = {"048484", "048024", "048484", "048024", "048484",
-                         "048024", "048484", "048024", "048484", "048024",
-                         "048484", "048024", "048484", "048024", "048484",
-                         "048024", "048484", "048024", "048484", "048024",
-                         "048484", "048024", "048484", "048024", "048484",
-                         "048024", "048484", "048024", "048484", "048024",
-                         "048484"},
-      .valid_time_period = "1000",
-      .originator_code = "WXR",
-      .event_code = "TOR",
-      .callsign = "WAEB/AM ",
-      .originator_time = "1172221",
-      .attn_sig_duration = 8};
+  const auto engine = static_cast<enum libsame_gen_engine>(state.range(0));
 
   struct libsame_gen_ctx ctx = {};
-  std::cout << "Generation engine: " << libsame_gen_engine_desc_get() << '\n';
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+  ctx.sin_gen = app_sin_gen;
+
+  state.SetLabel(libsame_gen_engine_desc_lookup(engine));
 
   libsame_init();
 
   for (auto _ : state) {
+    ctx.seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
     libsame_ctx_init(&ctx, &header, 44100);
+    libsame_ctx_gen_engine_set(&ctx, engine);
 
     while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
-      libsame_samples_gen(&ctx);
+      libsame_samples_gen(&ctx, samples);
     }
   }
 }
+
+void benchmark_afsk_templates(benchmark::State& state) {
+  const auto engine = static_cast<enum libsame_gen_engine>(state.range(0));
+
+  static struct libsame_afsk_templates templates = {};
+  struct libsame_gen_ctx ctx = {};
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+  ctx.sin_gen = app_sin_gen;
+
+  state.SetLabel(libsame_gen_engine_desc_lookup(engine));
+
+  libsame_init();
+
+  libsame_ctx_init(&ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&ctx, engine);
+  libsame_afsk_templates_init(&templates, &ctx);
+
+  for (auto _ : state) {
+    ctx.seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+    libsame_ctx_init(&ctx, &header, 44100);
+    libsame_ctx_gen_engine_set(&ctx, engine);
+    libsame_ctx_afsk_templates_set(&ctx, &templates);
+
+    while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+      libsame_samples_gen(&ctx, samples);
+    }
+  }
+}
+
+void benchmark_attn_sig_tile(benchmark::State& state) {
+  const auto engine = static_cast<enum libsame_gen_engine>(state.range(0));
+
+  static struct libsame_attn_sig_tile tile = {};
+  struct libsame_gen_ctx ctx = {};
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+  ctx.sin_gen = app_sin_gen;
+
+  state.SetLabel(libsame_gen_engine_desc_lookup(engine));
+
+  libsame_init();
+
+  libsame_ctx_init(&ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&ctx, engine);
+  libsame_attn_sig_tile_init(&tile, &ctx);
+
+  for (auto _ : state) {
+    ctx.seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+    libsame_ctx_init(&ctx, &header, 44100);
+    libsame_ctx_gen_engine_set(&ctx, engine);
+    libsame_ctx_attn_sig_tile_set(&ctx, &tile);
+
+    while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+      libsame_samples_gen(&ctx, samples);
+    }
+  }
+}
+
+void benchmark_header_burst_buf(benchmark::State& state) {
+  const auto engine = static_cast<enum libsame_gen_engine>(state.range(0));
+
+  static s16 buf[LIBSAME_HEADER_BURST_SAMPLES_MAX];
+  struct libsame_gen_ctx ctx = {};
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+  ctx.sin_gen = app_sin_gen;
+
+  state.SetLabel(libsame_gen_engine_desc_lookup(engine));
+
+  libsame_init();
+
+  for (auto _ : state) {
+    ctx.seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+    libsame_ctx_init(&ctx, &header, 44100);
+    libsame_ctx_gen_engine_set(&ctx, engine);
+    libsame_ctx_header_burst_buf_set(&ctx, buf,
+                                     LIBSAME_HEADER_BURST_SAMPLES_MAX);
+
+    while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+      libsame_samples_gen(&ctx, samples);
+    }
+  }
+}
+
+void benchmark_samples_gen_fmt(benchmark::State& state) {
+  const auto fmt = static_cast<enum libsame_sample_fmt>(state.range(0));
+
+  static u8 buf[LIBSAME_SAMPLES_NUM_MAX * sizeof(float)];
+  struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+
+  for (auto _ : state) {
+    ctx.seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+    libsame_ctx_init(&ctx, &header, 44100);
+    libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_DDS);
+
+    while (libsame_samples_gen_fmt(&ctx, fmt, buf, LIBSAME_SAMPLES_NUM_MAX) !=
+           0) {
+    }
+  }
+}
+
+/// Starts every generation context of a bulk render at a different position
+/// within its message.
+void batch_ctxs_start(struct libsame_gen_ctx* const ctxs,
+                      const size_t ctxs_num,
+                      const enum libsame_gen_engine engine) {
+  for (size_t i = 0; i < ctxs_num; ++i) {
+    ctxs[i].seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+    libsame_ctx_init(&ctxs[i], &header, 44100);
+    libsame_ctx_gen_engine_set(&ctxs[i], engine);
+    libsame_seek(&ctxs[i], i * 2503);
+  }
+}
+
+/// Advances a few hundred generation contexts by one buffer each, either one
+/// at a time with libsame_samples_gen_buf() or all at once with
+/// libsame_samples_gen_batch().
+void benchmark_samples_gen_batch(benchmark::State& state) {
+  const bool batch = state.range(0) != 0;
+  constexpr size_t CTXS_NUM = 256;
+  constexpr size_t NUM = 256;
+
+  static struct libsame_gen_ctx ctxs[CTXS_NUM];
+  static struct libsame_gen_ctx* ptrs[CTXS_NUM];
+  static s16 samples[CTXS_NUM * NUM];
+
+  state.SetLabel(batch ? "libsame_samples_gen_batch"
+                       : "libsame_samples_gen_buf");
+
+  libsame_init();
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    ptrs[i] = &ctxs[i];
+  }
+  batch_ctxs_start(ctxs, CTXS_NUM, LIBSAME_GEN_ENGINE_DDS);
+
+  for (auto _ : state) {
+    size_t total = 0;
+
+    if (batch) {
+      total = libsame_samples_gen_batch(ptrs, CTXS_NUM, samples, NUM, nullptr);
+    } else {
+      for (size_t i = 0; i < CTXS_NUM; ++i) {
+        total += libsame_samples_gen_buf(&ctxs[i], &samples[i * NUM], NUM);
+      }
+    }
+
+    if (total == 0) {
+      state.PauseTiming();
+      batch_ctxs_start(ctxs, CTXS_NUM, LIBSAME_GEN_ENGINE_DDS);
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * CTXS_NUM * NUM);
+}
+
+/// Advances many generation contexts using the polynomial generation engine by
+/// one buffer each, either one at a time with libsame_samples_gen_buf() or
+/// eight lanes at a time with libsame_samples_gen_multi().
+void benchmark_samples_gen_multi(benchmark::State& state) {
+  const bool multi = state.range(0) != 0;
+  constexpr size_t CTXS_NUM = 64;
+  constexpr size_t NUM = 1024;
+
+  static struct libsame_gen_ctx ctxs[CTXS_NUM];
+  static struct libsame_gen_ctx* ptrs[CTXS_NUM];
+  static s16 samples[CTXS_NUM * NUM];
+
+  state.SetLabel(multi ? "libsame_samples_gen_multi"
+                       : "libsame_samples_gen_buf");
+
+  libsame_init();
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    ptrs[i] = &ctxs[i];
+  }
+  batch_ctxs_start(ctxs, CTXS_NUM, LIBSAME_GEN_ENGINE_POLY);
+
+  for (auto _ : state) {
+    size_t total = 0;
+
+    if (multi) {
+      total = libsame_samples_gen_multi(ptrs, CTXS_NUM, samples, NUM, nullptr);
+    } else {
+      for (size_t i = 0; i < CTXS_NUM; ++i) {
+        total += libsame_samples_gen_buf(&ctxs[i], &samples[i * NUM], NUM);
+      }
+    }
+
+    if (total == 0) {
+      state.PauseTiming();
+      batch_ctxs_start(ctxs, CTXS_NUM, LIBSAME_GEN_ENGINE_POLY);
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * CTXS_NUM * NUM);
+}
+
+/// Renders a whole message at 48 kHz using a varying number of threads.
+void benchmark_samples_gen_parallel(benchmark::State& state) {
+  const auto threads_num = static_cast<unsigned int>(state.range(0));
+  constexpr size_t NUM = 48000 * 64;
+
+  static s16 samples[NUM];
+  struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, 48000);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_POLY);
+
+  size_t total = 0;
+
+  for (auto _ : state) {
+    total = libsame_samples_gen_parallel(&ctx, samples, NUM, threads_num);
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(total));
+}
+
+/// A bulk render sink which only counts the samples it receives.
+void bulk_sink_write(void* const userdata, const size_t, const s16* const,
+                     const size_t num) {
+  __atomic_fetch_add(static_cast<size_t*>(userdata), num, __ATOMIC_RELAXED);
+}
+
+/// Renders a set of messages of varying lengths over a varying number of
+/// threads.
+void benchmark_bulk_render(benchmark::State& state) {
+  const auto threads_num = static_cast<unsigned int>(state.range(0));
+  constexpr size_t HEADERS_NUM = 16;
+
+  static struct libsame_header headers[HEADERS_NUM];
+  size_t received = 0;
+
+  const struct libsame_bulk_sink sink = {.write = bulk_sink_write,
+                                         .done = nullptr,
+                                         .wav_map = nullptr,
+                                         .span_get = nullptr,
+                                         .span_put = nullptr,
+                                         .userdata = &received};
+
+  libsame_init();
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    headers[i] = header;
+    headers[i].attn_sig_duration =
+        8 + static_cast<unsigned int>((i * 7) % 18);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(libsame_bulk_render(headers, HEADERS_NUM, 22050,
+                                                 &sink, threads_num));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(received));
+}
+
+/// Archives a message as a WAV file, either written a block at a time with
+/// write() or generated directly into the file mapped at its final size with
+/// libsame_wav_render().
+void benchmark_wav_write(benchmark::State& state) {
+  const bool mapped = state.range(0) != 0;
+
+  static u8 buf[LIBSAME_SAMPLES_NUM_MAX * sizeof(s16)];
+  struct libsame_gen_ctx ctx = {};
+  FILE* const file = std::tmpfile();
+  const int fd = fileno(file);
+  size_t bytes = 0;
+
+  libsame_init();
+
+  for (auto _ : state) {
+    ctx.seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+    libsame_ctx_init(&ctx, &header, 44100);
+
+    const size_t size = libsame_wav_size_get(&ctx);
+
+    // Every iteration starts from an empty file, as every archived message
+    // would.
+    if ((ftruncate(fd, 0) != 0) ||
+        (ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+      state.SkipWithError("ftruncate() failed");
+      break;
+    }
+
+    if (mapped) {
+      void* const map =
+          mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+      if (map == MAP_FAILED) {
+        state.SkipWithError("mmap() failed");
+        break;
+      }
+      libsame_wav_render(&ctx, map, size);
+      munmap(map, size);
+    } else {
+      // Only the length of the data chunk matters to the comparison, so the
+      // header is left zeroed.
+      off_t pos = LIBSAME_WAV_HEADER_SIZE;
+      size_t num;
+
+      while ((num = libsame_samples_gen_fmt(&ctx, LIBSAME_SAMPLE_FMT_S16LE,
+                                            buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+             0) {
+        benchmark::DoNotOptimize(pwrite(fd, buf, num * sizeof(s16), pos));
+        pos += static_cast<off_t>(num * sizeof(s16));
+      }
+    }
+    bytes += size;
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  std::fclose(file);
+}
+
+/// Starts a producer thread streaming a new message.
+std::thread stream_start(struct libsame_stream* const stream,
+                         struct libsame_gen_ctx* const ctx, s16* const buf,
+                         const size_t buf_num) {
+  ctx->seq_state = LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST;
+  libsame_ctx_init(ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(ctx, LIBSAME_GEN_ENGINE_DDS);
+  libsame_stream_init(stream, ctx, buf, buf_num, buf_num / 4, buf_num / 2);
+
+  return std::thread([stream] {
+    while (!libsame_stream_done(stream)) {
+      if (libsame_stream_produce(stream) == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+}
+
+void benchmark_stream_read(benchmark::State& state) {
+  const auto num = static_cast<size_t>(state.range(0));
+  constexpr size_t BUF_NUM = 8192;
+
+  static struct libsame_stream stream = {};
+  static s16 buf[BUF_NUM];
+  struct libsame_gen_ctx ctx = {};
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+
+  libsame_init();
+
+  std::thread producer = stream_start(&stream, &ctx, buf, BUF_NUM);
+
+  // Each iteration is one audio callback, timed from entry to return while the
+  // producer runs concurrently. An audio device only calls back once enough
+  // samples have played, which gives the producer time to keep up; waiting
+  // for the samples to be buffered stands in for that. The end of a message
+  // can be shorter than a callback, so the wait also ends once the producer
+  // has finished.
+  for (auto _ : state) {
+    while ((libsame_stream_buffered(&stream) < num) &&
+           !__atomic_load_n(&stream.finished, __ATOMIC_ACQUIRE)) {
+      std::this_thread::yield();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    libsame_stream_read(&stream, samples, num);
+    const auto end = std::chrono::steady_clock::now();
+
+    state.SetIterationTime(
+        std::chrono::duration<double>(end - start).count());
+
+    if (libsame_stream_done(&stream)) {
+      producer.join();
+      producer = stream_start(&stream, &ctx, buf, BUF_NUM);
+    }
+  }
+
+  // The producer stops only once the rest of the message is read.
+  while (!libsame_stream_done(&stream)) {
+    libsame_stream_read(&stream, samples, num);
+    std::this_thread::yield();
+  }
+  producer.join();
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
 }  // namespace
-BENCHMARK(benchmark_default_path);
+BENCHMARK(benchmark_default_path)->DenseRange(0, LIBSAME_GEN_ENGINE_NUM - 1);
+BENCHMARK(benchmark_afsk_templates)->DenseRange(0, LIBSAME_GEN_ENGINE_NUM - 1);
+BENCHMARK(benchmark_attn_sig_tile)->DenseRange(0, LIBSAME_GEN_ENGINE_NUM - 1);
+BENCHMARK(benchmark_header_burst_buf)
+    ->DenseRange(0, LIBSAME_GEN_ENGINE_NUM - 1);
+
+BENCHMARK(benchmark_samples_gen_fmt)
+    ->DenseRange(0, LIBSAME_SAMPLE_FMT_NUM - 1);
+
+BENCHMARK(benchmark_samples_gen_batch)->DenseRange(0, 1);
+BENCHMARK(benchmark_samples_gen_multi)->DenseRange(0, 1);
+
+BENCHMARK(benchmark_bulk_render)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+BENCHMARK(benchmark_samples_gen_parallel)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+BENCHMARK(benchmark_wav_write)->DenseRange(0, 1)->UseRealTime();
+
+BENCHMARK(benchmark_stream_read)
+    ->RangeMultiplier(4)
+    ->Range(64, 1024)
+    ->UseManualTime();
 
 BENCHMARK_MAIN();
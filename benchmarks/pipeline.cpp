@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "libsame/libsame.h"
+#include "pipeline.h"
+
+namespace {
+/// The number of messages every iteration writes.
+constexpr size_t MESSAGES_NUM = 2000;
+
+/// The sample rate the messages are rendered at.
+constexpr unsigned int SAMPLE_RATE = 8000;
+
+/// Everything the sink needs to write the rendered messages.
+struct pipeline_render {
+  /// The pipeline the messages are written through.
+  struct pipeline* pipeline;
+
+  /// The directory the messages are written to.
+  std::string dir;
+
+  /// The number of samples in each message.
+  std::vector<size_t> samples_nums;
+
+  /// The message being written, or MESSAGES_NUM if none is.
+  size_t msg;
+
+  /// Whether writing any message failed.
+  bool failed;
+
+  /// Pads the flag up to the alignment of the message index.
+  u8 padding[sizeof(size_t) - sizeof(bool)];
+};
+
+/// Formats the path of the file of a message.
+std::string msg_path_get(const std::string& dir, const size_t msg) {
+  return dir + "/" + std::to_string(msg) + ".raw";
+}
+
+void* pipeline_sink_span_get(void* const userdata, const size_t msg,
+                             size_t* const size) {
+  auto* const render = static_cast<struct pipeline_render*>(userdata);
+
+  if (render->msg != msg) {
+    const std::string path = msg_path_get(render->dir, msg);
+
+    if (!pipeline_open(render->pipeline, path.c_str(),
+                       render->samples_nums[msg] * sizeof(s16),
+                       &render->failed)) {
+      return nullptr;
+    }
+    render->msg = msg;
+  }
+  return pipeline_span_get(render->pipeline, size);
+}
+
+void pipeline_sink_span_put(void* const userdata, const size_t,
+                            const size_t size) {
+  auto* const render = static_cast<struct pipeline_render*>(userdata);
+
+  pipeline_span_put(render->pipeline, size);
+}
+
+void pipeline_sink_done(void* const userdata, const size_t msg,
+                        const size_t) {
+  auto* const render = static_cast<struct pipeline_render*>(userdata);
+
+  if (render->msg == msg) {
+    pipeline_close(render->pipeline);
+    render->msg = MESSAGES_NUM;
+  }
+}
+
+/// Writes thousands of messages to raw PCM files on one thread through the
+/// output pipeline of same-render, using io_uring or pwrite(), with and
+/// without O_DIRECT.
+void benchmark_pipeline(benchmark::State& state) {
+  const auto backend = static_cast<enum pipeline_backend>(state.range(0));
+  const bool direct = state.range(1) != 0;
+
+  static struct libsame_header headers[MESSAGES_NUM];
+  struct pipeline_render render = {};
+  char dir[] = "/tmp/libsame_benchmark_pipeline.XXXXXX";
+
+  if (mkdtemp(dir) == nullptr) {
+    state.SkipWithError("mkdtemp() failed");
+    return;
+  }
+
+  render.dir = dir;
+  render.msg = MESSAGES_NUM;
+
+  for (size_t i = 0; i < MESSAGES_NUM; ++i) {
+    struct libsame_header* const header = &headers[i];
+    struct libsame_segment_map map;
+
+    *header = {};
+    std::snprintf(header->location_codes[0], sizeof(header->location_codes[0]),
+                  "%06zu", i);
+    std::snprintf(header->location_codes[1], sizeof(header->location_codes[1]),
+                  "%s", LIBSAME_LOCATION_CODE_END_MARKER);
+    std::snprintf(header->valid_time_period, sizeof(header->valid_time_period),
+                  "0030");
+    std::snprintf(header->originator_code, sizeof(header->originator_code),
+                  "WXR");
+    std::snprintf(header->event_code, sizeof(header->event_code), "TOR");
+    std::snprintf(header->callsign, sizeof(header->callsign), "KEWX/NWS");
+    std::snprintf(header->originator_time, sizeof(header->originator_time),
+                  "1231200");
+    header->attn_sig_duration = 8;
+
+    libsame_segment_map_get(&map, header, SAMPLE_RATE);
+    render.samples_nums.push_back(map.samples_num);
+  }
+
+  libsame_init();
+
+  const struct libsame_bulk_sink sink = {.write = nullptr,
+                                         .done = pipeline_sink_done,
+                                         .wav_map = nullptr,
+                                         .span_get = pipeline_sink_span_get,
+                                         .span_put = pipeline_sink_span_put,
+                                         .userdata = &render};
+  size_t bytes = 0;
+
+  for (auto _ : state) {
+    render.pipeline = pipeline_create(backend, direct);
+
+    if (render.pipeline == nullptr) {
+      state.SkipWithError("pipeline_create() failed");
+      break;
+    }
+
+    if (pipeline_backend_get(render.pipeline) != backend) {
+      pipeline_destroy(render.pipeline);
+      state.SkipWithError("io_uring is unavailable");
+      break;
+    }
+
+    bytes += libsame_bulk_render(headers, MESSAGES_NUM, SAMPLE_RATE, &sink, 1) *
+             sizeof(s16);
+
+    // Waits for the last writes.
+    pipeline_destroy(render.pipeline);
+  }
+
+  if (render.failed) {
+    state.SkipWithError("Writing a message failed");
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() *
+                                               MESSAGES_NUM));
+
+  for (size_t i = 0; i < MESSAGES_NUM; ++i) {
+    unlink(msg_path_get(render.dir, i).c_str());
+  }
+  rmdir(dir);
+}
+};  // namespace
+
+BENCHMARK(benchmark_pipeline)
+    ->ArgsProduct({{PIPELINE_BACKEND_URING, PIPELINE_BACKEND_PWRITE}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -29,6 +29,28 @@
 // The audio device to use for outputting the SAME header.
 static SDL_AudioDeviceID audio_dev_id;
 
+// The number of samples the audio device asks for in each callback. Smaller
+// values lower the latency, at the cost of more frequent callbacks.
+#define CALLBACK_SAMPLES_NUM (512)
+
+// The number of samples the stream buffers. This must be a power of two, and
+// should be a few callbacks long, so that the generating thread has time to
+// keep up.
+#define STREAM_BUF_NUM (4096)
+
+// The stream passes samples from the main thread to the audio callback through
+// a ring buffer we provide, without locks or dynamic memory allocation.
+static struct libsame_stream stream;
+static s16 stream_buf[STREAM_BUF_NUM];
+
+// This function is called by SDL on its audio thread whenever the audio device
+// needs more samples. It must not block, so it only copies samples out of the
+// stream; they are generated ahead of time on the main thread.
+static void audio_callback(void *const userdata, Uint8 *const dst,
+                           const int len) {
+  libsame_stream_read(userdata, (s16 *)dst, (size_t)len / sizeof(s16));
+}
+
 // This function is called when the application terminates via the end of main()
 // or a call to exit().
 static void example_on_exit(void) {
@@ -94,7 +116,9 @@ int main(void) {
   audio_spec.freq = SAMPLE_RATE;
   audio_spec.format = AUDIO_S16LSB;
   audio_spec.channels = 1;
-  audio_spec.samples = LIBSAME_SAMPLES_NUM_MAX;
+  audio_spec.samples = CALLBACK_SAMPLES_NUM;
+  audio_spec.callback = audio_callback;
+  audio_spec.userdata = &stream;
 
   audio_dev_id = SDL_OpenAudioDevice(NULL, 0, &audio_spec, NULL, 0);
   if (audio_dev_id == 0) {
@@ -121,9 +145,9 @@ int main(void) {
   // this populates the internal sine wave lookup table.
   libsame_init();
 
-  // This structure handles the generation context; since we generate
-  // LIBSAME_SAMPLES_NUM_MAX at a time, we need a way to keep track of where we
-  // are during the generation process. It must *always* be zeroed out upon
+  // This structure handles the generation context; since we generate a few
+  // callbacks worth of samples at a time, we need a way to keep track of where
+  // we are during the generation process. It must *always* be zeroed out upon
   // declaration.
   struct libsame_gen_ctx ctx = {};
 
@@ -131,28 +155,29 @@ int main(void) {
   // calculate how many samples it will take for each state in the generation.
   libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
 
+  // Whenever fewer than two callbacks worth of samples are buffered, top the
+  // ring buffer up to four callbacks worth. The latency is therefore at most
+  // four callbacks.
+  libsame_stream_init(&stream, &ctx, stream_buf, STREAM_BUF_NUM,
+                      2 * CALLBACK_SAMPLES_NUM, 4 * CALLBACK_SAMPLES_NUM);
+
+  // Buffer some samples before the audio device starts asking for them.
+  libsame_stream_produce(&stream);
+
   // Enable the audio device.
   SDL_PauseAudioDevice(audio_dev_id, 0);
 
   printf("Generating and playing SAME header...\n");
 
-  // Do not stop generating audio samples until we have reached the end of the
-  // possible states.
-  while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
-    // Generate LIBSAME_SAMPLES_NUM_MAX samples.
-    libsame_samples_gen(&ctx);
-
-    // Now push them to the audio device.
-    if (SDL_QueueAudio(audio_dev_id, ctx.sample_data,
-                       sizeof(s16) * LIBSAME_SAMPLES_NUM_MAX) < 0) {
-      fprintf(stderr, "SDL_QueueAudio() failed: %s\n", SDL_GetError());
-      return EXIT_FAILURE;
+  // Keep the ring buffer topped up until every sample has been played.
+  while (!libsame_stream_done(&stream)) {
+    if (libsame_stream_produce(&stream) == 0) {
+      SDL_Delay(1);
     }
   }
 
-  // While we could calculate algorithmically how long it will take to
-  // completely play the output, an estimate just is fine.
-  SDL_Delay(20000);
+  // The audio device may still be playing the samples of the last callback.
+  SDL_Delay(100);
   printf("Done!\n");
 
   return EXIT_SUCCESS;
@@ -38,6 +38,7 @@
 extern "C" {
 #endif  // __cplusplus
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -101,6 +102,26 @@ extern "C" {
 /// The number of audio samples per chunk.
 #define LIBSAME_SAMPLES_NUM_MAX (4096U)
 
+/// The lowest sample rate a SAME message can be faithfully rendered at: the
+/// first standard rate above the Nyquist rate of the 2083.3 Hz AFSK mark tone.
+#define LIBSAME_SAMPLE_RATE_MIN (8000U)
+
+/// The highest sample rate objects sized by sample rate, such as AFSK bit
+/// templates, are sized for.
+#define LIBSAME_SAMPLE_RATE_MAX (96000U)
+
+/// The most samples one AFSK bit spans at LIBSAME_SAMPLE_RATE_MAX.
+#define LIBSAME_AFSK_SAMPLES_PER_BIT_MAX (185U)
+
+/// The most samples one AFSK header burst spans at LIBSAME_SAMPLE_RATE_MAX.
+#define LIBSAME_HEADER_BURST_SAMPLES_MAX                                       \
+  (LIBSAME_HEADER_SIZE_MAX * 8 * LIBSAME_AFSK_SAMPLES_PER_BIT_MAX)
+
+/// The number of start phases an AFSK bit template is rendered at for
+/// generation engines which keep their phase across bits. The phase of a bit
+/// is rounded to the nearest of these.
+#define LIBSAME_AFSK_TEMPLATE_PHASES_NUM (64U)
+
 /// Defines the generation sequence states.
 ///
 /// The sequence states dictate what portion of the SAME header we are
@@ -153,12 +174,94 @@ enum libsame_seq_state {
   LIBSAME_SEQ_STATE_NUM
 };
 
-/// Defines the generation engine that libsame was compiled for.
+/// Defines the generation engines libsame provides.
+///
+/// Every generation engine is compiled into the library; each generation
+/// context selects the one it uses with libsame_ctx_gen_engine_set().
 enum libsame_gen_engine {
   LIBSAME_GEN_ENGINE_LIBC,
   LIBSAME_GEN_ENGINE_LUT,
-  LIBSAME_GEN_ENGINE_TAYLOR,
-  LIBSAME_GEN_ENGINE_APP
+
+  /// Odd minimax polynomial evaluated on a 32-bit phase accumulator in single
+  /// precision floating point.
+  LIBSAME_GEN_ENGINE_POLY,
+
+  /// The three-order Taylor Series engine this slot used to hold was replaced
+  /// by the minimax polynomial engine, which is faster and more accurate.
+  LIBSAME_GEN_ENGINE_TAYLOR = LIBSAME_GEN_ENGINE_POLY,
+
+  LIBSAME_GEN_ENGINE_APP,
+
+  /// Odd minimax polynomial evaluated over whole spans of samples with
+  /// SSE2/AVX2 kernels where available.
+  LIBSAME_GEN_ENGINE_SIMD,
+
+  /// Direct digital synthesis using 32-bit integer phase accumulators and the
+  /// sine wave lookup table. No floating point is used per sample.
+  LIBSAME_GEN_ENGINE_DDS,
+
+  /// Rotate a complex phasor by a fixed angle per sample, renormalising its
+  /// magnitude periodically.
+  LIBSAME_GEN_ENGINE_ROTATOR,
+
+  /// Odd minimax polynomial evaluated on a 32-bit phase accumulator in Q15
+  /// fixed point. No floating point is used per sample.
+  LIBSAME_GEN_ENGINE_POLY_FIXED,
+
+  /// The total number of generation engines. Do not modify or remove this
+  /// entry.
+  LIBSAME_GEN_ENGINE_NUM
+};
+
+/// Defines the output sample formats generation can write directly.
+enum libsame_sample_fmt {
+  /// Signed 16-bit little-endian samples.
+  LIBSAME_SAMPLE_FMT_S16LE,
+
+  /// Signed 16-bit big-endian samples.
+  LIBSAME_SAMPLE_FMT_S16BE,
+
+  /// Packed signed 24-bit little-endian samples, three bytes each.
+  LIBSAME_SAMPLE_FMT_S24LE,
+
+  /// Signed 32-bit little-endian samples.
+  LIBSAME_SAMPLE_FMT_S32LE,
+
+  /// Native-endian 32-bit floating point samples in the range [-1, 1).
+  LIBSAME_SAMPLE_FMT_F32,
+
+  /// The total number of output sample formats. Do not modify or remove this
+  /// entry.
+  LIBSAME_SAMPLE_FMT_NUM
+};
+
+/// The number of distinct tones making up a SAME header: the AFSK mark and
+/// space frequencies, and the two fundamental frequencies of the attention
+/// signal.
+#define LIBSAME_TONES_NUM (4U)
+
+/// The number of bytes at the start of a generation context holding the state
+/// read or written on every call to the libsame_samples_gen function.
+#define LIBSAME_GEN_CTX_HOT_SIZE (128U)
+
+/// Defines the state of an oscillator. Which member is in use depends on the
+/// generation engine in use; this is not intended for public use.
+union libsame_osc {
+  /// The phase accumulator of the LUT engine, in lookup table entries.
+  float lut_phase;
+
+  /// The phase accumulator of the DDS engine, in units of 2^-32 turns.
+  u32 acc;
+
+  /// The phasor of the rotator engine. A zeroed phasor is treated as being at
+  /// phase zero.
+  struct {
+    /// The real (cosine) component.
+    float re;
+
+    /// The imaginary (sine) component.
+    float im;
+  } rot;
 };
 
 /// Defines the header to be used for transmission.
@@ -188,28 +291,203 @@ struct libsame_header {
   unsigned int attn_sig_duration;
 };
 
+/// Defines a set of pre-rendered AFSK bits.
+///
+/// Every AFSK bit is afsk_samples_per_bit samples of either the mark or space
+/// frequency, so a generation context given a set of templates copies each bit
+/// instead of synthesizing it. One set of templates can be shared by any
+/// number of generation contexts using the same sample rate and generation
+/// engine; it is never modified after libsame_afsk_templates_init().
+///
+/// Generation engines which restart their phase on every bit need only one
+/// template per bit value and produce exactly the same samples as without
+/// templates. Generation engines which keep their phase across bits use the
+/// template rendered at the start phase nearest to theirs, and are therefore
+/// up to half of 1/LIBSAME_AFSK_TEMPLATE_PHASES_NUM of a turn out of phase.
+/// Templates only apply to the header bursts; EOM bursts are always exact, as
+/// they are shared through the EOM burst cache.
+struct libsame_afsk_templates {
+  /// The samples of each template, indexed by bit value and start phase.
+  s16 samples[2][LIBSAME_AFSK_TEMPLATE_PHASES_NUM]
+             [LIBSAME_AFSK_SAMPLES_PER_BIT_MAX];
+
+  /// The sample rate the templates were rendered at.
+  uint sample_rate;
+
+  /// The generation engine the templates were rendered with.
+  enum libsame_gen_engine gen_engine;
+
+  /// The number of start phases rendered; either 1 or
+  /// LIBSAME_AFSK_TEMPLATE_PHASES_NUM.
+  uint phases_num;
+};
+
+/// Defines one period of the attention signal.
+///
+/// Both fundamental frequencies of the attention signal are whole numbers of
+/// hertz, so it repeats exactly after at most one second. A generation context
+/// given a tile copies the attention signal from it instead of synthesizing
+/// it. One tile can be shared by any number of generation contexts using the
+/// same sample rate and generation engine; it is never modified after
+/// libsame_attn_sig_tile_init().
+///
+/// The first period is exactly what the generation engine would synthesize.
+/// Later periods repeat it, rather than carrying the rounding error the
+/// generation engine accumulates over a long tone.
+struct libsame_attn_sig_tile {
+  /// The samples of one period of the attention signal.
+  s16 samples[LIBSAME_SAMPLE_RATE_MAX];
+
+  /// The number of samples in one period of the attention signal.
+  uint samples_num;
+
+  /// The sample rate the tile was rendered at.
+  uint sample_rate;
+
+  /// The generation engine the tile was rendered with.
+  enum libsame_gen_engine gen_engine;
+};
+
+/// Defines one segment of a message; every sequence state is one segment.
+struct libsame_segment {
+  /// The sequence state the segment is generated in.
+  enum libsame_seq_state state;
+
+  /// Pads the sequence state up to the alignment of the sample counts. This is
+  /// not intended for public use.
+  u32 state_padding;
+
+  /// The sample position the segment starts at, counted from the start of the
+  /// message.
+  size_t start;
+
+  /// The number of samples in the segment.
+  size_t num;
+};
+
+/// Defines the layout of a whole message.
+struct libsame_segment_map {
+  /// The segments of the message, in the order they are generated.
+  struct libsame_segment segments[LIBSAME_SEQ_STATE_NUM];
+
+  /// The total number of samples in the message.
+  size_t samples_num;
+};
+
+/// The number of bytes the producer and consumer state of a stream are kept
+/// apart by, such that they never share a cache line.
+#define LIBSAME_STREAM_CACHE_LINE_SIZE (64)
+
+/// The number of bytes reserved in a renderer for the handle of its worker
+/// thread.
+#define LIBSAME_RENDERER_THREAD_SIZE (16)
+
+/// The most threads libsame_samples_gen_parallel() renders a message with.
+#define LIBSAME_PARALLEL_THREADS_MAX (16)
+
+/// The most threads libsame_bulk_render() renders messages with.
+#define LIBSAME_BULK_THREADS_MAX (64)
+
+/// The number of bytes in the header of a WAV file libsame_wav_render()
+/// renders.
+#define LIBSAME_WAV_HEADER_SIZE (44)
+
+/// Defines where libsame_bulk_render() delivers the messages it renders.
+///
+/// Every function is called from every rendering thread at once, but never for
+/// the same message from two threads.
+struct libsame_bulk_sink {
+  /// Receives the next span of samples of a message, or NULL if wav_map or
+  /// span_get is set.
+  ///
+  /// @param userdata The userdata of the sink.
+  /// @param msg The index of the header the message was rendered from.
+  /// @param samples The samples.
+  /// @param num The number of samples.
+  void (*write)(void *userdata, size_t msg, const s16 *samples, size_t num);
+
+  /// Called once every sample of a message was written, or NULL.
+  ///
+  /// @param userdata The userdata of the sink.
+  /// @param msg The index of the header the message was rendered from.
+  /// @param samples_num The number of samples in the message.
+  void (*done)(void *userdata, size_t msg, size_t samples_num);
+
+  /// Provides the memory to render a message into as a whole WAV file, or
+  /// NULL to deliver samples through write instead.
+  ///
+  /// The samples are generated directly into the memory returned, typically a
+  /// file mapped with its final size, and done is called once they all are.
+  ///
+  /// @param userdata The userdata of the sink.
+  /// @param msg The index of the header the message is rendered from.
+  /// @param size The size of the WAV file in bytes, as calculated by
+  ///             libsame_wav_size_get().
+  /// @returns Where to render the WAV file, or NULL to skip the message.
+  void *(*wav_map)(void *userdata, size_t msg, size_t size);
+
+  /// Provides the memory to generate the next span of a message into, or NULL
+  /// to deliver samples through write instead. This is ignored if wav_map is
+  /// set.
+  ///
+  /// The samples are generated directly into the memory returned, in
+  /// LIBSAME_SAMPLE_FMT_S16LE, typically the free part of an output buffer;
+  /// span_put is then called with the number of bytes they take up.
+  ///
+  /// @param userdata The userdata of the sink.
+  /// @param msg The index of the header the message is rendered from.
+  /// @param size Where to store the number of bytes the memory can hold. This
+  ///             must be at least two.
+  /// @returns Where to generate the samples, or NULL to stop rendering the
+  ///          message.
+  void *(*span_get)(void *userdata, size_t msg, size_t *size);
+
+  /// Called once samples were generated into the memory span_get returned, or
+  /// NULL if span_get is.
+  ///
+  /// @param userdata The userdata of the sink.
+  /// @param msg The index of the header the message is rendered from.
+  /// @param size The number of bytes generated, which is less than span_get
+  ///             made room for only at the end of the message.
+  void (*span_put)(void *userdata, size_t msg, size_t size);
+
+  /// Passed to every function as is.
+  void *userdata;
+};
+
 /// Defines the generation context.
 ///
 /// A generation context keeps track of the audio generation state over each
-/// call to the libsame_samples_gen function.
+/// call to the libsame_samples_gen function. It holds no audio samples itself;
+/// the caller provides the storage they are generated into, so a generation
+/// context is cheap to keep around in large numbers.
+///
+/// The state read or written on every call occupies the first
+/// LIBSAME_GEN_CTX_HOT_SIZE bytes, which is two cache lines. What follows is
+/// read only by initialization, seeking, the libc and application specified
+/// engines, at the start of a segment or, for the header data, once every
+/// eight AFSK bits, so the context as a whole is larger than two cache lines.
+/// The rotator engine is the exception: it reads its phasors from the colder
+/// part once per call.
 struct libsame_gen_ctx {
-  /// The buffer containing the audio samples.
-  s16 sample_data[LIBSAME_SAMPLES_NUM_MAX];
+  /// The current sequence of the generation.
+  enum libsame_seq_state seq_state;
 
-  /// The header data to generate an AFSK burst from.
-  u8 header_data[LIBSAME_HEADER_SIZE_MAX];
+  /// The generation engine in use by this context.
+  enum libsame_gen_engine gen_engine;
 
-  /// The number of samples remaining for each generation sequence.
-  uint seq_samples_remaining[LIBSAME_SEQ_STATE_NUM];
+  /// The number of samples per bit as defined by the specified sample rate for
+  /// AFSK bursts.
+  uint afsk_samples_per_bit;
 
   /// Defines the current AFSK state.
   struct {
-    /// The current position within the data.
-    size_t data_pos;
+    /// The oscillator for AFSK bursts. This only matters if the generation
+    /// engine keeps a phase accumulator and is not intended for public use.
+    union libsame_osc phase;
 
-    /// The phase accumulator for AFSK bursts. This only matters if the
-    /// generation engine is the LUT and is not intended for public use.
-    float phase;
+    /// The current position within the data.
+    uint data_pos;
 
     /// The current bit we're generating a sine wave for.
     uint bit_pos;
@@ -218,6 +496,46 @@ struct libsame_gen_ctx {
     uint sample_num;
   } afsk;
 
+  /// The actual size of the header to care about.
+  uint header_size;
+
+  /// The phase accumulator for the first fundamental frequency of the attention
+  /// signal.
+  union libsame_osc attn_sig_phase_first;
+
+  /// The phase accumulator for the second fundamental frequency of the
+  /// attention signal.
+  union libsame_osc attn_sig_phase_second;
+
+  /// The current sample we're generating for the attention signal.
+  uint attn_sig_sample_num;
+
+  /// The phase increment per sample of each tone in units of 2^-32 turns, as
+  /// defined by the specified sample rate. These are in the order of the AFSK
+  /// mark frequency, the AFSK space frequency, and the first and second
+  /// fundamental frequencies of the attention signal.
+  u32 phase_incs[LIBSAME_TONES_NUM];
+
+  /// The number of samples remaining for each generation sequence.
+  uint seq_samples_remaining[LIBSAME_SEQ_STATE_NUM];
+
+  /// The sample rate as specified by libsame_ctx_init().
+  uint sample_rate;
+
+  /// The duration of the attention signal in seconds, as specified by the
+  /// header given to libsame_ctx_init().
+  uint attn_sig_duration;
+
+  /// The cosine of the angle each tone advances by per sample, in the same
+  /// order as phase_incs. This is used by the rotator engine, and is only
+  /// calculated once it is selected.
+  float rot_cos[LIBSAME_TONES_NUM];
+
+  /// The sine of the angle each tone advances by per sample, in the same order
+  /// as phase_incs. This is used by the rotator engine, and is only calculated
+  /// once it is selected.
+  float rot_sin[LIBSAME_TONES_NUM];
+
   /// The function to call when a sine wave needs to be generated.
   ///
   /// This only matters if the generation engine in use is the application
@@ -234,29 +552,136 @@ struct libsame_gen_ctx {
   /// specified generator.
   void *sin_gen_userdata;
 
-  /// The actual size of the header to care about.
-  size_t header_size;
+  /// The AFSK bit templates to copy AFSK bits from, if any. These are ignored
+  /// unless they were rendered at the sample rate and with the generation
+  /// engine in use.
+  const struct libsame_afsk_templates *afsk_templates;
 
-  /// The phase accumulator for the first fundamental frequency of the attention
-  /// signal.
-  float attn_sig_phase_first;
+  /// The attention signal tile to copy the attention signal from, if any. This
+  /// is ignored unless it was rendered at the sample rate and with the
+  /// generation engine in use.
+  const struct libsame_attn_sig_tile *attn_sig_tile;
 
-  /// The phase accumulator for the second fundamental frequency of the
-  /// attention signal.
-  float attn_sig_phase_second;
+  /// The buffer the first AFSK header burst is captured in, if any, such that
+  /// the second and third can be copied from it.
+  s16 *header_burst_buf;
 
-  /// The sample rate as specified by libsame_ctx_init().
-  uint sample_rate;
+  /// The number of samples header_burst_buf can hold.
+  size_t header_burst_buf_num;
 
-  /// The number of samples per bit as defined by the specified sample rate for
-  /// AFSK bursts.
-  uint afsk_samples_per_bit;
+  /// The number of samples of the first AFSK header burst captured so far.
+  size_t header_burst_captured;
 
-  /// The current sequence of the generation.
-  enum libsame_seq_state seq_state;
+  /// The header data to generate an AFSK burst from.
+  u8 header_data[LIBSAME_HEADER_SIZE_MAX];
 
-  /// The current sample we're generating for the attention signal.
-  uint attn_sig_sample_num;
+  /// Pads the header data up to the alignment of the generation context. This
+  /// is not intended for public use.
+  u8 header_data_padding[8 - (LIBSAME_HEADER_SIZE_MAX % 8)];
+};
+
+/// Defines a stream, which passes samples from a producer thread generating
+/// them to a consumer thread playing them out.
+///
+/// The read and write positions count every sample that has passed through
+/// the ring buffer, and are reduced to an index into it only when accessed.
+/// Each is written by one thread alone; the other thread only loads it.
+struct libsame_stream {
+  /// The generation context the producer generates from.
+  struct libsame_gen_ctx *ctx;
+
+  /// The ring buffer.
+  s16 *buf;
+
+  /// The number of samples the ring buffer can hold, minus one.
+  size_t mask;
+
+  /// The number of buffered samples below which the producer refills the ring
+  /// buffer.
+  size_t low_water;
+
+  /// The number of buffered samples the producer refills the ring buffer to.
+  size_t high_water;
+
+  /// The number of samples the producer has written. Written by the producer.
+  size_t write_pos;
+
+  /// Whether the producer has reached the end of the sequence. Written by the
+  /// producer.
+  uint finished;
+
+  /// Keeps the consumer state off the cache line of the producer state, and
+  /// pads the finished flag up to the alignment of the read position.
+  u8 pad[LIBSAME_STREAM_CACHE_LINE_SIZE + sizeof(size_t) - sizeof(uint)];
+
+  /// The number of samples the consumer has read. Written by the consumer.
+  size_t read_pos;
+
+  /// The number of reads which found fewer samples buffered than they asked
+  /// for. Written by the consumer; other threads may load it.
+  size_t underruns;
+};
+
+/// Defines a renderer, which owns a worker thread rendering a message ahead of
+/// the playout position into a stream.
+///
+/// Three threads take part: the control thread, which calls the lifecycle
+/// functions; the worker thread, which the renderer starts and stops; and the
+/// audio thread, which only copies samples out with libsame_renderer_read().
+struct libsame_renderer {
+  /// The stream the worker thread produces into.
+  struct libsame_stream stream;
+
+  /// The handle of the worker thread, valid while it is running.
+  union {
+    /// Aligns the handle.
+    u64 align;
+
+    /// The storage of the handle.
+    u8 bytes[LIBSAME_RENDERER_THREAD_SIZE];
+  } thread;
+
+  /// The number of nanoseconds the worker thread sleeps for when the ring
+  /// buffer does not need refilling.
+  u64 poll_ns;
+
+  /// The number of times the worker thread refilled the ring buffer. Written
+  /// by the worker thread.
+  size_t refills;
+
+  /// Whether the worker thread is running. Written by the control thread.
+  uint running;
+
+  /// Whether the worker thread was asked to stop. Written by the control
+  /// thread.
+  uint stop_requested;
+
+  /// Whether the rest of the message was discarded. Written by the control
+  /// thread.
+  uint flushed;
+
+  /// Pads the flags up to the alignment of the renderer. This is not intended
+  /// for public use.
+  uint flags_padding;
+};
+
+/// Defines the fill-level counters of a renderer.
+struct libsame_renderer_stats {
+  /// The number of samples rendered ahead of the playout position.
+  size_t buffered;
+
+  /// The number of samples rendered in total.
+  size_t rendered;
+
+  /// The number of samples played out in total.
+  size_t played;
+
+  /// The number of times the ring buffer was refilled.
+  size_t refills;
+
+  /// The number of reads which found fewer samples buffered than they asked
+  /// for, before the end of the message.
+  size_t underruns;
 };
 
 void libsame_init(void);
@@ -264,18 +689,499 @@ void libsame_init(void);
 void libsame_ctx_init(struct libsame_gen_ctx *ctx,
                       const struct libsame_header *header, uint sample_rate);
 
-void libsame_samples_gen(struct libsame_gen_ctx *ctx);
+void libsame_samples_gen(struct libsame_gen_ctx *ctx, s16 *dst);
+
+/// Generates the audio samples for the SAME header into a caller-provided
+/// buffer of any length, in the specified output sample format.
+///
+/// Samples are converted to the output sample format a small block at a time as
+/// they are generated, rather than in a second pass over the whole buffer.
+/// Generation resumes where the previous call left off, and can be freely
+/// mixed with libsame_samples_gen() and libsame_samples_gen_buf().
+///
+/// @param ctx The generation context.
+/// @param fmt The output sample format.
+/// @param dst Where to store the generated samples. No alignment is required.
+/// @param num The number of samples dst can hold.
+/// @returns The number of samples generated. This is less than num only once
+///          the end of the sequence is reached, and zero if it was already
+///          reached.
+size_t libsame_samples_gen_fmt(struct libsame_gen_ctx *ctx,
+                               enum libsame_sample_fmt fmt, void *dst,
+                               size_t num);
+
+/// Generates the audio samples for the SAME header into channels of a
+/// caller-provided interleaved frame buffer, in the specified output sample
+/// format.
+///
+/// Each sample is stored to channels consecutive channels of its frame,
+/// starting at dst; the other channels of every frame are left untouched.
+/// Generation resumes where the previous call left off, and can be freely
+/// mixed with the other generation functions.
+///
+/// @param ctx The generation context.
+/// @param fmt The output sample format.
+/// @param dst Where to store the first channel to write of the first frame. No
+///            alignment is required.
+/// @param num The number of frames dst can hold.
+/// @param stride The number of samples in one frame of dst; 1 for a contiguous
+///               buffer.
+/// @param channels The number of consecutive channels to store each sample to.
+///                 This must be at least 1 and must not exceed stride.
+/// @returns The number of frames generated. This is less than num only once
+///          the end of the sequence is reached, and zero if it was already
+///          reached.
+size_t libsame_samples_gen_strided(struct libsame_gen_ctx *ctx,
+                                   enum libsame_sample_fmt fmt, void *dst,
+                                   size_t num, size_t stride, size_t channels);
+
+/// Retrieves the number of bytes one sample occupies in an output sample
+/// format.
+///
+/// @param fmt The output sample format.
+/// @returns The number of bytes one sample occupies.
+size_t libsame_sample_fmt_size_get(enum libsame_sample_fmt fmt);
+
+/// Calculates the layout of the message a header generates at a sample rate,
+/// without generating any audio.
+///
+/// @param map Where to store the layout of the message.
+/// @param header The header the message is generated from.
+/// @param sample_rate The sample rate the message is generated at.
+void libsame_segment_map_get(struct libsame_segment_map *map,
+                             const struct libsame_header *header,
+                             uint sample_rate);
+
+/// Moves a generation context to an absolute sample position within the
+/// message, such that generation continues from there.
+///
+/// The sequence state, the AFSK position and the phase of every oscillator are
+/// calculated directly from the position, so the cost does not depend on how
+/// far into the message the position is. Generation engines which keep their
+/// phase in an integer accumulator, or do not keep one at all, produce exactly
+/// the samples they would have produced had the message been generated from
+/// the start; those which accumulate their phase in floating point differ only
+/// by the rounding error they would have accumulated.
+///
+/// Seeking backwards is allowed. Seeking to or past the end of the message
+/// finishes the sequence.
+///
+/// @param ctx The generation context, initialized by libsame_ctx_init().
+/// @param sample_pos The number of samples from the start of the message to
+///                   continue generation from.
+void libsame_seek(struct libsame_gen_ctx *ctx, size_t sample_pos);
 
-/// Retrieves the generation engine this version of libsame was compiled for.
+/// Generates the audio samples for the SAME header into a caller-provided
+/// buffer of any length.
+///
+/// Generation resumes where the previous call to this function or
+/// libsame_samples_gen() left off; the two can be freely mixed.
+///
+/// @param ctx The generation context.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples dst can hold.
+/// @returns The number of samples generated. This is less than num only once
+///          the end of the sequence is reached, and zero if it was already
+///          reached.
+size_t libsame_samples_gen_buf(struct libsame_gen_ctx *ctx, s16 *dst,
+                               size_t num);
+
+/// Initializes a stream, which lets an audio callback pull samples that are
+/// generated ahead of time on another thread.
 ///
-/// @returns The generation engine this version of libsame was compiled for.
+/// A stream pairs one producer thread, which calls libsame_stream_produce(),
+/// with one consumer thread, usually the audio callback, which calls
+/// libsame_stream_read(). Samples pass between them through a ring buffer the
+/// caller provides; neither side takes a lock or allocates memory, and the
+/// consumer side never waits.
+///
+/// The producer tops the ring buffer up to high_water samples whenever it has
+/// drained below low_water samples, so the latency from generation to playout
+/// is at most high_water samples, and the consumer can go without the producer
+/// for at least low_water samples before it runs out.
+///
+/// @param stream The stream to initialize.
+/// @param ctx The generation context the producer generates from, initialized
+///            by libsame_ctx_init(). It must not be used by anything else
+///            until the stream is done.
+/// @param buf The ring buffer. It must outlive the stream.
+/// @param buf_num The number of samples buf can hold. This must be a power of
+///                two.
+/// @param low_water The number of buffered samples below which the producer
+///                  refills the ring buffer. This must be at least 1.
+/// @param high_water The number of buffered samples the producer refills the
+///                   ring buffer to. This must be at least low_water, and must
+///                   not exceed buf_num.
+void libsame_stream_init(struct libsame_stream *stream,
+                         struct libsame_gen_ctx *ctx, s16 *buf, size_t buf_num,
+                         size_t low_water, size_t high_water);
+
+/// Refills the ring buffer of a stream if it has drained below its low water
+/// mark.
+///
+/// This must only be called from the producer thread of the stream.
+///
+/// @param stream The stream.
+/// @returns The number of samples generated, which is zero if the ring buffer
+///          did not need refilling or the end of the sequence was reached.
+size_t libsame_stream_produce(struct libsame_stream *stream);
+
+/// Reads samples from the ring buffer of a stream.
+///
+/// If fewer samples are buffered than were asked for, the rest of dst is
+/// filled with silence and the stream counts an underrun. This must only be
+/// called from the consumer thread of the stream.
+///
+/// @param stream The stream.
+/// @param dst Where to store the samples.
+/// @param num The number of samples to store.
+/// @returns The number of samples read from the ring buffer.
+size_t libsame_stream_read(struct libsame_stream *stream, s16 *dst,
+                           size_t num);
+
+/// Retrieves the number of samples buffered in the ring buffer of a stream,
+/// which is the latency the stream currently adds.
+///
+/// This may be called from either thread of the stream; the other thread can
+/// change the number at any moment.
+///
+/// @param stream The stream.
+/// @returns The number of samples buffered.
+size_t libsame_stream_buffered(const struct libsame_stream *stream);
+
+/// Determines whether every sample of the sequence has passed through a
+/// stream.
+///
+/// This may be called from either thread of the stream.
+///
+/// @param stream The stream.
+/// @returns true once the producer has reached the end of the sequence and
+///          the consumer has read every sample it generated.
+bool libsame_stream_done(const struct libsame_stream *stream);
+
+/// Initializes a renderer.
+///
+/// The ring buffer and water marks behave as they do for
+/// libsame_stream_init(). The worker thread is not started yet.
+///
+/// @param renderer The renderer to initialize.
+/// @param ctx The generation context to render from, initialized by
+///            libsame_ctx_init(). It must not be used by anything else until
+///            the renderer is done.
+/// @param buf The ring buffer. It must outlive the renderer.
+/// @param buf_num The number of samples buf can hold. This must be a power of
+///                two.
+/// @param low_water The number of buffered samples below which the worker
+///                  thread refills the ring buffer. This must be at least 1.
+/// @param high_water The number of buffered samples the worker thread refills
+///                   the ring buffer to. This must be at least low_water, and
+///                   must not exceed buf_num.
+void libsame_renderer_init(struct libsame_renderer *renderer,
+                           struct libsame_gen_ctx *ctx, s16 *buf,
+                           size_t buf_num, size_t low_water,
+                           size_t high_water);
+
+/// Starts the worker thread of a renderer.
+///
+/// If the ring buffer has drained below the low water mark, it is refilled
+/// before this returns, so the audio thread can start reading at once. A
+/// stopped renderer can be started again, and continues where it stopped.
+///
+/// @param renderer The renderer, which must not be running.
+/// @returns true if the worker thread was started, or false if it could not
+///          be, or the host has no thread support.
+bool libsame_renderer_start(struct libsame_renderer *renderer);
+
+/// Stops the worker thread of a renderer, waiting for it to exit.
+///
+/// Samples already rendered stay buffered and can still be read. Does nothing
+/// if the renderer is not running.
+///
+/// @param renderer The renderer.
+void libsame_renderer_stop(struct libsame_renderer *renderer);
+
+/// Discards the rest of the message a renderer is rendering, including the
+/// samples already buffered.
+///
+/// From the next read on, the audio thread only reads silence, and the
+/// renderer is done as soon as the audio thread has caught up with the worker
+/// thread.
+///
+/// @param renderer The renderer.
+void libsame_renderer_flush(struct libsame_renderer *renderer);
+
+/// Reads samples rendered by a renderer.
+///
+/// This never blocks. If fewer samples are buffered than were asked for, the
+/// rest of dst is filled with silence. This must only be called from the audio
+/// thread.
+///
+/// @param renderer The renderer.
+/// @param dst Where to store the samples.
+/// @param num The number of samples to store.
+/// @returns The number of rendered samples read.
+size_t libsame_renderer_read(struct libsame_renderer *renderer, s16 *dst,
+                             size_t num);
+
+/// Determines whether every sample of the message a renderer renders has been
+/// read, or discarded by libsame_renderer_flush().
+///
+/// @param renderer The renderer.
+/// @returns true once the renderer is done.
+bool libsame_renderer_done(const struct libsame_renderer *renderer);
+
+/// Retrieves the fill-level counters of a renderer.
+///
+/// This may be called from any thread; the counters are each loaded
+/// atomically, but not all at one instant.
+///
+/// @param renderer The renderer.
+/// @param stats Where to store the counters.
+void libsame_renderer_stats_get(const struct libsame_renderer *renderer,
+                                struct libsame_renderer_stats *stats);
+
+/// Generates the audio samples for many SAME headers at once, each into its
+/// own span of a caller-provided buffer.
+///
+/// This is equivalent to calling libsame_samples_gen_buf() on every generation
+/// context in turn, but the contexts are grouped by the kind of segment they
+/// are generating and then by their generation engine, such that the same
+/// generator runs over many contexts back to back. The constants each run
+/// reads, such as the phase increments, are still those of its own context.
+/// The contexts can be at any point of their messages, and need not share a
+/// sample rate or generation engine.
+///
+/// @param ctxs The generation contexts. Each must appear only once.
+/// @param ctxs_num The number of generation contexts.
+/// @param dst Where to store the generated samples. The samples of ctxs[i] are
+///            stored to the num samples starting at dst[i * num].
+/// @param num The number of samples each span of dst can hold.
+/// @param generated Where to store the number of samples generated for each
+///                  generation context, or NULL. Each is less than num only
+///                  once the end of that sequence is reached.
+/// @returns The total number of samples generated, which is zero once every
+///          sequence has ended.
+size_t libsame_samples_gen_batch(struct libsame_gen_ctx *const *ctxs,
+                                 size_t ctxs_num, s16 *dst, size_t num,
+                                 size_t *generated);
+
+/// Generates the audio samples for many SAME headers at once, interleaved
+/// into frames of one sample per SAME header.
+///
+/// The generator state of every group of 8 generation contexts is kept as
+/// one lane per context, and one sample of every lane is computed at once
+/// with SIMD instructions where the host has them. Only generation contexts
+/// using LIBSAME_GEN_ENGINE_POLY are generated this way; those using any other
+/// engine are generated one at a time with libsame_samples_gen_buf(), and gain
+/// nothing from being passed here. The samples are identical to those
+/// libsame_samples_gen_buf() would generate, as long as no AFSK bit templates
+/// or attention signal tile are attached to a polynomial context, since every
+/// one of its samples is synthesized. The contexts can be at any point of their
+/// messages.
+///
+/// @param ctxs The generation contexts. Each must appear only once.
+/// @param ctxs_num The number of generation contexts.
+/// @param dst Where to store the generated samples. Frame f is stored to the
+///            ctxs_num samples starting at dst[f * ctxs_num], with the sample
+///            of ctxs[i] at index i. Past the end of its sequence, the samples
+///            of a generation context are silence.
+/// @param num The number of frames dst can hold.
+/// @param generated Where to store the number of samples generated for each
+///                  generation context, or NULL. Each is less than num only
+///                  once the end of that sequence is reached.
+/// @returns The total number of samples generated, which is zero once every
+///          sequence has ended.
+size_t libsame_samples_gen_multi(struct libsame_gen_ctx *const *ctxs,
+                                 size_t ctxs_num, s16 *dst, size_t num,
+                                 size_t *generated);
+
+/// Renders a message using several threads, each rendering a range of whole
+/// segments with its own copy of the generation context.
+///
+/// The samples are identical to those libsame_samples_gen_buf() would generate
+/// for the generation context, for every generation engine, since each segment
+/// starts from cleared oscillators. The ranges are balanced by the number of
+/// non-silent samples in them, so the attention signal bounds how much faster
+/// this can be than rendering the message on one thread.
+///
+/// The calling thread renders the first range itself, and any range a thread
+/// could not be started for. If the application specified generation engine is
+/// in use, its generator is called from every thread at once.
+///
+/// @param ctx The generation context, initialized by libsame_ctx_init() and
+///            at the start of the message. It is not modified.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples dst can hold.
+/// @param threads_num The number of threads to render the message with,
+///                    including the calling thread. At most
+///                    LIBSAME_PARALLEL_THREADS_MAX are used, and no more than
+///                    there are segments.
+/// @returns The number of samples generated, which is less than num only if the
+///          whole message was generated.
+size_t libsame_samples_gen_parallel(const struct libsame_gen_ctx *ctx,
+                                    s16 *dst, size_t num, uint threads_num);
+
+/// Renders many messages, one per header, over a pool of threads.
+///
+/// Each message is rendered by one thread, with a generation context of its
+/// own using the default generation engine. Every thread starts with an even
+/// share of the messages, and takes half of the remaining share of another
+/// thread whenever it runs out, such that no thread idles while messages
+/// remain. The calling thread renders as well, and renders every message if
+/// no other thread can be started.
+///
+/// libsame_init() must have been called.
+///
+/// @param headers The headers to render messages from.
+/// @param headers_num The number of headers.
+/// @param sample_rate The sample rate to render every message at.
+/// @param sink Where to deliver the rendered messages.
+/// @param threads_num The number of threads to render with, including the
+///                    calling thread. At most LIBSAME_BULK_THREADS_MAX are
+///                    used, and no more than there are headers.
+/// @returns The total number of samples rendered.
+size_t libsame_bulk_render(const struct libsame_header *headers,
+                           size_t headers_num, uint sample_rate,
+                           const struct libsame_bulk_sink *sink,
+                           uint threads_num);
+
+/// Stores the header of a 16-bit mono PCM WAV file, as libsame_wav_render()
+/// stores it.
+///
+/// This is for writing a WAV file piece by piece, such as through a
+/// libsame_bulk_sink with no wav_map function; the samples then follow in
+/// LIBSAME_SAMPLE_FMT_S16LE.
+///
+/// @param dst Where to store the header. This must hold LIBSAME_WAV_HEADER_SIZE
+///            bytes; no alignment is required.
+/// @param sample_rate The sample rate of the samples.
+/// @param samples_num The number of samples the file holds.
+void libsame_wav_header_store(void *dst, unsigned int sample_rate,
+                              size_t samples_num);
+
+/// Calculates the size of the WAV file libsame_wav_render() renders the rest of
+/// the message of a generation context into, without generating any audio.
+///
+/// @param ctx The generation context. It is not modified.
+/// @returns The size of the WAV file in bytes, including its header.
+size_t libsame_wav_size_get(const struct libsame_gen_ctx *ctx);
+
+/// Renders the rest of the message of a generation context as a 16-bit mono
+/// PCM WAV file.
+///
+/// The header is stored first, and the samples are then generated directly
+/// into the data chunk after it. The size of the file is known up front, so
+/// dst is meant to be a file mapped at its final size, which the message is
+/// then written to without any intermediate copy or write call.
+///
+/// @param ctx The generation context.
+/// @param dst Where to store the WAV file. No alignment is required, but the
+///            samples are generated in place only when dst is aligned to two
+///            bytes on a little-endian host.
+/// @param size The number of bytes dst can hold. This must be at least what
+///             libsame_wav_size_get() returns.
+/// @returns The number of samples generated.
+size_t libsame_wav_render(struct libsame_gen_ctx *ctx, void *dst, size_t size);
+
+/// Selects the generation engine a generation context uses.
+///
+/// This must be called after libsame_ctx_init(), as libsame_ctx_init() resets
+/// the generation engine to the default one.
+///
+/// Selecting the rotator engine calculates the angle each tone advances by per
+/// sample, at the cost of a cosf() and a sinf() call per tone; no other engine
+/// needs them, so libsame_ctx_init() does not calculate them otherwise.
+///
+/// @param ctx The generation context.
+/// @param engine The generation engine to use.
+void libsame_ctx_gen_engine_set(struct libsame_gen_ctx *ctx,
+                                enum libsame_gen_engine engine);
+
+/// Renders a set of AFSK bit templates.
+///
+/// The templates are rendered at the sample rate and with the generation engine
+/// of the specified generation context, which *MUST* have been initialized by
+/// using libsame_ctx_init(). The state of the generation context is not
+/// modified.
+///
+/// @param templates The templates to render.
+/// @param ctx The generation context to render the templates for.
+void libsame_afsk_templates_init(struct libsame_afsk_templates *templates,
+                                 struct libsame_gen_ctx *ctx);
+
+/// Makes a generation context copy AFSK bits from a set of templates.
+///
+/// This must be called after libsame_ctx_init(), as libsame_ctx_init() detaches
+/// any templates. The templates must outlive their use by the generation
+/// context.
+///
+/// @param ctx The generation context.
+/// @param templates The templates to copy from, or NULL to synthesize every
+///                  AFSK bit.
+void libsame_ctx_afsk_templates_set(
+    struct libsame_gen_ctx *ctx,
+    const struct libsame_afsk_templates *templates);
+
+/// Renders one period of the attention signal.
+///
+/// The tile is rendered at the sample rate and with the generation engine of
+/// the specified generation context, which *MUST* have been initialized by
+/// using libsame_ctx_init(). The state of the generation context is not
+/// modified.
+///
+/// @param tile The tile to render.
+/// @param ctx The generation context to render the tile for.
+void libsame_attn_sig_tile_init(struct libsame_attn_sig_tile *tile,
+                                struct libsame_gen_ctx *ctx);
+
+/// Makes a generation context copy the attention signal from a tile.
+///
+/// This must be called after libsame_ctx_init(), as libsame_ctx_init() detaches
+/// any tile. The tile must outlive its use by the generation context.
+///
+/// @param ctx The generation context.
+/// @param tile The tile to copy from, or NULL to synthesize the attention
+///             signal.
+void libsame_ctx_attn_sig_tile_set(struct libsame_gen_ctx *ctx,
+                                   const struct libsame_attn_sig_tile *tile);
+
+/// Gives a generation context a buffer to capture the first AFSK header burst
+/// in. The second and third AFSK header bursts are then copied from it rather
+/// than synthesized, producing exactly the same samples.
+///
+/// The buffer is only used if it can hold the whole burst. Once
+/// libsame_ctx_init() returns, the number of samples in the burst is the
+/// number remaining for LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST, which is never
+/// more than LIBSAME_HEADER_BURST_SAMPLES_MAX. The first burst is only captured
+/// if the buffer is set before it is generated.
+///
+/// This must be called after libsame_ctx_init(), as libsame_ctx_init() detaches
+/// any buffer. The buffer must outlive its use by the generation context.
+///
+/// @param ctx The generation context.
+/// @param buf The buffer to capture the first AFSK header burst in, or NULL to
+///            synthesize every AFSK header burst.
+/// @param num The number of samples the buffer can hold.
+void libsame_ctx_header_burst_buf_set(struct libsame_gen_ctx *ctx, s16 *buf,
+                                      size_t num);
+
+/// Retrieves the generation engine contexts use by default, as specified at
+/// compile-time by LIBSAME_GENERATION_ENGINE.
+///
+/// @returns The generation engine contexts use by default.
 enum libsame_gen_engine libsame_gen_engine_get(void);
 
-/// Retrieves the full description of the generation engine in use.
+/// Retrieves the full description of the default generation engine.
 ///
-/// @returns The full description of the generation engine in use.
+/// @returns The full description of the default generation engine.
 const char *libsame_gen_engine_desc_get(void);
 
+/// Retrieves the full description of a generation engine.
+///
+/// @param engine The generation engine to describe.
+/// @returns The full description of the generation engine.
+const char *libsame_gen_engine_desc_lookup(enum libsame_gen_engine engine);
+
 /// Retrieves both the minimum and maximum number of seconds an attention signal
 /// can be.
 ///
@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file bulk.c
+/// Defines the implementation of bulk rendering.
+///
+/// Every thread owns a range of message indices, packed into one 64-bit word
+/// as [begin, end). The owner takes messages from the front of its range, and
+/// a thread whose range runs dry steals the back half of another thread's
+/// range; both update the word with a compare-and-swap, so no message is
+/// rendered twice. Message lengths vary widely, so threads which drew short
+/// messages keep taking work from those which drew long ones until every range
+/// is empty.
+
+#include <assert.h>
+#include <string.h>
+
+#include "libsame/libsame.h"
+
+#if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#include <threads.h>
+
+/// Bulk renders are spread over several threads.
+#define BULK_HAVE_THREADS
+#endif  // !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+
+/// Defines the state shared by every thread of a bulk render.
+struct bulk {
+  /// The headers of the messages.
+  const struct libsame_header *headers;
+
+  /// Where the rendered messages go.
+  const struct libsame_bulk_sink *sink;
+
+  /// The threads rendering.
+  struct bulk_worker *workers;
+
+  /// The sample rate the messages are rendered at.
+  uint sample_rate;
+
+  /// The number of threads rendering.
+  uint workers_num;
+};
+
+#ifdef BULK_HAVE_THREADS
+/// The number of bytes padding a thread of a bulk render out to a whole cache
+/// line.
+#define BULK_WORKER_PADDING                                                    \
+  (LIBSAME_STREAM_CACHE_LINE_SIZE - sizeof(u64) - sizeof(thrd_t) -             \
+   sizeof(struct bulk *) - (2 * sizeof(size_t)) - sizeof(bool))
+#endif  // BULK_HAVE_THREADS
+
+/// Defines one thread of a bulk render.
+struct bulk_worker {
+#ifdef BULK_HAVE_THREADS
+  /// The range of message indices the thread owns, with the first index in the
+  /// low 32 bits and one past the last in the high 32 bits. Kept on a cache
+  /// line of its own, since other threads poll it when stealing.
+  _Alignas(LIBSAME_STREAM_CACHE_LINE_SIZE) _Atomic u64 range;
+
+  /// The thread.
+  thrd_t thread;
+#endif  // BULK_HAVE_THREADS
+
+  /// The state shared by every thread.
+  struct bulk *bulk;
+
+  /// The index of the thread.
+  size_t id;
+
+  /// The number of samples the thread rendered.
+  size_t rendered;
+
+#ifdef BULK_HAVE_THREADS
+  /// Whether the thread was started.
+  bool started;
+
+  /// Pads the thread out to a whole cache line.
+  u8 padding[BULK_WORKER_PADDING];
+#endif  // BULK_HAVE_THREADS
+};
+
+#ifdef BULK_HAVE_THREADS
+_Static_assert(sizeof(struct bulk_worker) == LIBSAME_STREAM_CACHE_LINE_SIZE,
+               "A thread of a bulk render must take up one cache line.");
+#endif  // BULK_HAVE_THREADS
+
+/// Renders one message to the sink of a bulk render.
+///
+/// @param worker The thread rendering the message.
+/// @param msg The index of the message.
+static void bulk_msg_render(struct bulk_worker *const worker,
+                            const size_t msg) {
+  const struct bulk *const bulk = worker->bulk;
+  const struct libsame_bulk_sink *const sink = bulk->sink;
+
+  struct libsame_gen_ctx ctx;
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+  size_t msg_num = 0;
+  size_t num;
+
+  memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &bulk->headers[msg], bulk->sample_rate);
+
+  if (sink->wav_map != NULL) {
+    const size_t size = libsame_wav_size_get(&ctx);
+    void *const dst = sink->wav_map(sink->userdata, msg, size);
+
+    if (dst != NULL) {
+      msg_num = libsame_wav_render(&ctx, dst, size);
+    }
+  } else if (sink->span_get != NULL) {
+    size_t size;
+    void *dst;
+
+    while ((dst = sink->span_get(sink->userdata, msg, &size)) != NULL) {
+      assert(size >= sizeof(s16));
+
+      const size_t span_num = size / sizeof(s16);
+
+      num = libsame_samples_gen_fmt(&ctx, LIBSAME_SAMPLE_FMT_S16LE, dst,
+                                    span_num);
+      sink->span_put(sink->userdata, msg, num * sizeof(s16));
+      msg_num += num;
+
+      if (num < span_num) {
+        break;
+      }
+    }
+  } else {
+    while ((num = libsame_samples_gen_buf(&ctx, samples,
+                                          LIBSAME_SAMPLES_NUM_MAX)) != 0) {
+      sink->write(sink->userdata, msg, samples, num);
+      msg_num += num;
+    }
+  }
+
+  if (sink->done != NULL) {
+    sink->done(sink->userdata, msg, msg_num);
+  }
+  worker->rendered += msg_num;
+}
+
+#ifdef BULK_HAVE_THREADS
+/// Packs a range of message indices.
+static inline u64 range_pack(const u64 begin, const u64 end) {
+  return begin | (end << 32);
+}
+
+/// Takes the message at the front of the range of a thread.
+///
+/// @param worker The thread.
+/// @param msg Where to store the index of the message taken.
+/// @returns false if the range is empty.
+static bool range_pop(struct bulk_worker *const worker, size_t *const msg) {
+  u64 range = atomic_load_explicit(&worker->range, memory_order_acquire);
+
+  for (;;) {
+    const u64 begin = range & UINT32_MAX;
+    const u64 end = range >> 32;
+
+    if (begin >= end) {
+      return false;
+    }
+
+    if (atomic_compare_exchange_weak_explicit(
+            &worker->range, &range, range_pack(begin + 1, end),
+            memory_order_acq_rel, memory_order_acquire)) {
+      *msg = (size_t)begin;
+      return true;
+    }
+  }
+}
+
+/// Steals the back half of the range of another thread.
+///
+/// @param worker The thread whose range ran dry.
+/// @returns false if every other range is empty as well.
+static bool range_steal(struct bulk_worker *const worker) {
+  const struct bulk *const bulk = worker->bulk;
+
+  for (size_t i = 1; i < bulk->workers_num; ++i) {
+    struct bulk_worker *const victim =
+        &bulk->workers[(worker->id + i) % bulk->workers_num];
+
+    u64 range = atomic_load_explicit(&victim->range, memory_order_acquire);
+
+    for (;;) {
+      const u64 begin = range & UINT32_MAX;
+      const u64 end = range >> 32;
+
+      if (begin >= end) {
+        break;
+      }
+
+      const u64 split = end - ((end - begin + 1) / 2);
+
+      if (atomic_compare_exchange_weak_explicit(
+              &victim->range, &range, range_pack(begin, split),
+              memory_order_acq_rel, memory_order_acquire)) {
+        atomic_store_explicit(&worker->range, range_pack(split, end),
+                              memory_order_release);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// The entry point of every thread of a bulk render.
+static int bulk_worker_run(void *const arg) {
+  struct bulk_worker *const worker = arg;
+  size_t msg;
+
+  for (;;) {
+    if (range_pop(worker, &msg)) {
+      bulk_msg_render(worker, msg);
+    } else if (!range_steal(worker)) {
+      return 0;
+    }
+  }
+}
+#endif  // BULK_HAVE_THREADS
+
+size_t libsame_bulk_render(const struct libsame_header *const restrict headers,
+                           const size_t headers_num, const uint sample_rate,
+                           const struct libsame_bulk_sink *const restrict sink,
+                           uint threads_num) {
+  assert((headers != NULL) || (headers_num == 0));
+  assert(headers_num <= UINT32_MAX);
+  assert(sample_rate > 0);
+  assert(sink != NULL);
+  assert((sink->write != NULL) || (sink->wav_map != NULL) ||
+         ((sink->span_get != NULL) && (sink->span_put != NULL)));
+  assert(threads_num > 0);
+
+  if (threads_num > LIBSAME_BULK_THREADS_MAX) {
+    threads_num = LIBSAME_BULK_THREADS_MAX;
+  }
+
+  if (threads_num > headers_num) {
+    threads_num = (headers_num != 0) ? (uint)headers_num : 1;
+  }
+
+  struct bulk_worker workers[LIBSAME_BULK_THREADS_MAX];
+  struct bulk bulk = {.headers = headers,
+                      .sample_rate = sample_rate,
+                      .sink = sink,
+                      .workers_num = threads_num,
+                      .workers = workers};
+
+#ifdef BULK_HAVE_THREADS
+  // Start out with an even share of messages each; stealing takes care of
+  // the difference in their lengths.
+  for (size_t i = 0; i < threads_num; ++i) {
+    workers[i].bulk = &bulk;
+    workers[i].id = i;
+    workers[i].rendered = 0;
+    workers[i].started = false;
+
+    atomic_init(&workers[i].range,
+                range_pack((headers_num * i) / threads_num,
+                           (headers_num * (i + 1)) / threads_num));
+  }
+
+  for (size_t i = 1; i < threads_num; ++i) {
+    workers[i].started = (thrd_create(&workers[i].thread, bulk_worker_run,
+                                      &workers[i]) == thrd_success);
+  }
+
+  // The calling thread renders as well. Ranges of threads which could not be
+  // started are stolen by those which were.
+  bulk_worker_run(&workers[0]);
+
+  size_t rendered = 0;
+
+  for (size_t i = 0; i < threads_num; ++i) {
+    if (workers[i].started) {
+      thrd_join(workers[i].thread, NULL);
+    }
+    rendered += workers[i].rendered;
+  }
+  return rendered;
+#else
+  workers[0].bulk = &bulk;
+  workers[0].id = 0;
+  workers[0].rendered = 0;
+
+  for (size_t msg = 0; msg < headers_num; ++msg) {
+    bulk_msg_render(&workers[0], msg);
+  }
+  return workers[0].rendered;
+#endif  // BULK_HAVE_THREADS
+}
@@ -43,6 +43,23 @@ extern "C" {
 #define UNREACHABLE
 #endif  // __GNUC__
 
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+/// Indicates that the host stores multi-byte values least significant byte
+/// first.
+#define HOST_LITTLE_ENDIAN
+#endif  // __BYTE_ORDER__
+
+#ifdef __GNUC__
+/// Loads a value shared between threads, such that no memory access after it
+/// is reordered before it.
+#define LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+
+/// Stores a value shared between threads, such that no memory access before it
+/// is reordered after it.
+#define STORE_RELEASE(ptr, value) \
+  __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#endif  // __GNUC__
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file eom_cache.c
+/// Defines the implementation of the process-wide EOM burst cache.
+///
+/// Each slot moves through its states exactly once, in order:
+///
+///     EMPTY -> CLAIMED -> RENDERING -> READY
+///
+/// A thread claims an empty slot with a compare-and-swap, records the sample
+/// rate and generation engine, then publishes RENDERING so other threads
+/// looking for the same configuration synthesize their burst instead of
+/// claiming a second slot for it. Two threads missing the cache at the same
+/// moment can still both claim a slot for one configuration; this only wastes
+/// the slot. READY is published with release semantics
+/// once the samples are written, and is the only state in which other threads
+/// read the samples.
+
+#include "eom_cache.h"
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include "libsame_config.h"
+
+#if (LIBSAME_CONFIG_EOM_CACHE_SLOTS > 0) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+
+/// Defines the states of a cache slot.
+enum eom_cache_state {
+  /// The slot is unused.
+  EOM_CACHE_STATE_EMPTY,
+
+  /// The slot was claimed; its key is being written.
+  EOM_CACHE_STATE_CLAIMED,
+
+  /// The key of the slot is valid; the samples are being rendered.
+  EOM_CACHE_STATE_RENDERING,
+
+  /// The key and samples of the slot are valid.
+  EOM_CACHE_STATE_READY
+};
+
+/// Defines a cache slot.
+struct eom_cache_slot {
+  /// The state of the slot.
+  atomic_uint state;
+
+  /// The sample rate the EOM burst was rendered at.
+  uint sample_rate;
+
+  /// The generation engine the EOM burst was rendered with.
+  enum libsame_gen_engine gen_engine;
+
+  /// The samples of the EOM burst.
+  s16 samples[EOM_CACHE_SAMPLES_MAX];
+};
+
+/// The cache slots.
+static struct eom_cache_slot slots[LIBSAME_CONFIG_EOM_CACHE_SLOTS];
+
+/// Determines if a cache slot holds a key matching a generation context.
+static bool slot_matches(const struct eom_cache_slot *const slot,
+                         const struct libsame_gen_ctx *const ctx) {
+  return (slot->sample_rate == ctx->sample_rate) &&
+         (slot->gen_engine == ctx->gen_engine);
+}
+
+const s16 *eom_cache_get(struct libsame_gen_ctx *const ctx, const size_t num,
+                         const eom_cache_render_fn render) {
+  assert(ctx != NULL);
+
+  // The application specified generator belongs to the generation context,
+  // not the configuration. EOM bursts above LIBSAME_SAMPLE_RATE_MAX do not fit
+  // in a slot, and are always synthesized.
+  if ((ctx->gen_engine == LIBSAME_GEN_ENGINE_APP) ||
+      (ctx->sample_rate > LIBSAME_SAMPLE_RATE_MAX)) {
+    return NULL;
+  }
+  assert(num <= EOM_CACHE_SAMPLES_MAX);
+
+  for (size_t i = 0; i < LIBSAME_CONFIG_EOM_CACHE_SLOTS; ++i) {
+    const uint state =
+        atomic_load_explicit(&slots[i].state, memory_order_acquire);
+
+    if ((state == EOM_CACHE_STATE_EMPTY) ||
+        (state == EOM_CACHE_STATE_CLAIMED) || !slot_matches(&slots[i], ctx)) {
+      continue;
+    }
+    return (state == EOM_CACHE_STATE_READY) ? slots[i].samples : NULL;
+  }
+
+  if (render == NULL) {
+    return NULL;
+  }
+
+  for (size_t i = 0; i < LIBSAME_CONFIG_EOM_CACHE_SLOTS; ++i) {
+    uint expected = EOM_CACHE_STATE_EMPTY;
+
+    if (!atomic_compare_exchange_strong_explicit(
+            &slots[i].state, &expected, EOM_CACHE_STATE_CLAIMED,
+            memory_order_acquire, memory_order_relaxed)) {
+      continue;
+    }
+
+    slots[i].sample_rate = ctx->sample_rate;
+    slots[i].gen_engine = ctx->gen_engine;
+    atomic_store_explicit(&slots[i].state, EOM_CACHE_STATE_RENDERING,
+                          memory_order_release);
+
+    render(ctx, slots[i].samples, num);
+    atomic_store_explicit(&slots[i].state, EOM_CACHE_STATE_READY,
+                          memory_order_release);
+
+    return slots[i].samples;
+  }
+  return NULL;
+}
+#else
+const s16 *eom_cache_get(struct libsame_gen_ctx *const ctx, const size_t num,
+                         const eom_cache_render_fn render) {
+  (void)ctx;
+  (void)num;
+  (void)render;
+
+  return NULL;
+}
+#endif  // (LIBSAME_CONFIG_EOM_CACHE_SLOTS > 0) &&
+        // !defined(__STDC_NO_ATOMICS__)
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file eom_cache.h
+/// Defines the interface of the process-wide EOM burst cache.
+///
+/// The End of Message burst is identical for every message generated at a
+/// given sample rate with a given generation engine, so it is rendered once
+/// into a fixed number of statically allocated slots and copied from then on.
+/// Slots are claimed lazily and never evicted; once every slot is in use, EOM
+/// bursts for other configurations are synthesized as usual.
+
+#ifndef LIBSAME_PRIVATE_EOM_CACHE_H
+#define LIBSAME_PRIVATE_EOM_CACHE_H
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#include "libsame/libsame.h"
+
+/// The most samples an EOM burst spans at LIBSAME_SAMPLE_RATE_MAX: the
+/// preamble and "NNNN", at 8 bits per character.
+#define EOM_CACHE_SAMPLES_MAX                                                  \
+  ((LIBSAME_PREAMBLE_NUM + 4) * 8 * LIBSAME_AFSK_SAMPLES_PER_BIT_MAX)
+
+/// Renders an EOM burst.
+///
+/// @param ctx The generation context to render the EOM burst with.
+/// @param dst Where to store the rendered samples.
+/// @param num The number of samples in the EOM burst.
+typedef void (*eom_cache_render_fn)(struct libsame_gen_ctx *const ctx,
+                                    s16 *const dst, const size_t num);
+
+/// Retrieves the cached EOM burst for the sample rate and generation engine of
+/// a generation context.
+///
+/// This is safe to call from any number of threads at once.
+///
+/// @param ctx The generation context.
+/// @param num The number of samples in the EOM burst. This must not exceed
+///            EOM_CACHE_SAMPLES_MAX at sample rates up to
+///            LIBSAME_SAMPLE_RATE_MAX; nothing is cached above it.
+/// @param render The function to render the EOM burst with if it is not cached
+///               yet and a slot is free, or NULL to only look it up.
+/// @returns The samples of the EOM burst, or NULL if it is not cached.
+const s16 *eom_cache_get(struct libsame_gen_ctx *const ctx, const size_t num,
+                         const eom_cache_render_fn render);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // LIBSAME_PRIVATE_EOM_CACHE_H
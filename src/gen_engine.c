@@ -0,0 +1,405 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file gen_engine.c
+/// Defines the implementation of the generation engines.
+
+#include "gen_engine.h"
+
+#include <assert.h>
+#include <math.h>
+
+#include "libsame_config.h"
+
+/// The value of PI up to 35 decimal places.
+#define PI (3.14159265358979323846264338327950288F)
+
+/// The number of samples the rotator engine generates between renormalizing
+/// the magnitude of its phasor.
+#define ROT_RENORM_INTERVAL (64U)
+
+/// The sine wave lookup table used by the LUT and DDS engines. The final entry
+/// is a copy of the first, such that interpolating from the last entry never
+/// needs to wrap the index.
+static s16 sin_lut[LIBSAME_CONFIG_SINE_LUT_SIZE + 1];
+
+const float gen_tone_freqs[GEN_TONE_NUM] = {
+    [GEN_TONE_AFSK_MARK] = AFSK_MARK_FREQ,
+    [GEN_TONE_AFSK_SPACE] = AFSK_SPACE_FREQ,
+    [GEN_TONE_ATTN_SIG_FIRST] = ATTN_SIG_FREQ_FIRST,
+    [GEN_TONE_ATTN_SIG_SECOND] = ATTN_SIG_FREQ_SECOND};
+
+const u32 gen_tone_freqs_dhz[GEN_TONE_NUM] = {
+    [GEN_TONE_AFSK_MARK] = 20833,
+    [GEN_TONE_AFSK_SPACE] = 15625,
+    [GEN_TONE_ATTN_SIG_FIRST] = 8530,
+    [GEN_TONE_ATTN_SIG_SECOND] = 9600};
+
+/// Generates a span of samples of a sine wave using the libc sinf() function.
+static void tone_gen_libc(struct libsame_gen_ctx *const restrict ctx,
+                          union libsame_osc *const restrict osc,
+                          const uint sample_num, const enum gen_tone tone,
+                          s16 *const restrict dst, const size_t num) {
+  (void)osc;
+
+  const float freq = gen_tone_freqs[tone];
+
+  for (size_t i = 0; i < num; ++i) {
+    const float t = (float)(sample_num + i) / (float)ctx->sample_rate;
+    dst[i] = (s16)(sinf(PI * 2 * t * freq) * INT16_MAX);
+  }
+}
+
+/// Generates a span of samples of a sine wave using the sine wave lookup
+/// table.
+static void tone_gen_lut(struct libsame_gen_ctx *const restrict ctx,
+                         union libsame_osc *const restrict osc,
+                         const uint sample_num, const enum gen_tone tone,
+                         s16 *const restrict dst, const size_t num) {
+  (void)sample_num;
+  assert(osc != NULL);
+
+  const float delta = (gen_tone_freqs[tone] * LIBSAME_CONFIG_SINE_LUT_SIZE) /
+                      (float)ctx->sample_rate;
+
+  for (size_t i = 0; i < num; ++i) {
+    float integral;
+    const float frac = modff(osc->lut_phase, &integral);
+
+    const s16 v0 = sin_lut[(size_t)integral + 0];
+    const s16 v1 = sin_lut[(size_t)integral + 1];
+
+    dst[i] = (s16)((float)v0 + ((float)v1 - (float)v0) * frac);
+
+    osc->lut_phase += delta;
+
+    while (osc->lut_phase >= (LIBSAME_CONFIG_SINE_LUT_SIZE - 1)) {
+      osc->lut_phase -= LIBSAME_CONFIG_SINE_LUT_SIZE;
+    }
+  }
+}
+
+/// Generates a span of samples of a sine wave using a degree 7 odd minimax
+/// polynomial in single precision floating point.
+///
+/// The polynomial approximates sin(2 * PI * y) for y in [-0.25, 0.25] turns
+/// with a maximum absolute error of 5.9e-7, far below one output LSB. Every
+/// sample is independent of the last, so the loop vectorizes.
+static void tone_gen_poly(struct libsame_gen_ctx *const restrict ctx,
+                          union libsame_osc *const restrict osc,
+                          const uint sample_num, const enum gen_tone tone,
+                          s16 *const restrict dst, const size_t num) {
+  (void)sample_num;
+  assert(osc != NULL);
+
+  const u32 inc = ctx->phase_incs[tone];
+  const u32 acc = osc->acc;
+
+  for (size_t i = 0; i < num; ++i) {
+    const s32 folded = gen_poly_phase_fold(acc + ((u32)i * inc));
+    dst[i] = gen_poly_sample((float)folded * GEN_POLY_ACC_SCALE);
+  }
+  osc->acc = acc + ((u32)num * inc);
+}
+
+/// Generates a span of samples of a sine wave using a degree 7 odd minimax
+/// polynomial in Q15 fixed point.
+///
+/// This is the same polynomial as the floating point variant, rescaled to take
+/// the phase in quarter turns. Every step rounds to nearest; the maximum
+/// absolute error of the output is 2 LSB.
+static void tone_gen_poly_fixed(struct libsame_gen_ctx *const restrict ctx,
+                                union libsame_osc *const restrict osc,
+                                const uint sample_num, const enum gen_tone tone,
+                                s16 *const restrict dst, const size_t num) {
+  (void)sample_num;
+  assert(osc != NULL);
+
+  const s32 C1 = 51472;
+  const s32 C3 = -21165;
+  const s32 C5 = 2603;
+  const s32 C7 = -142;
+
+  const s32 ROUND = 1 << 14;
+
+  const u32 inc = ctx->phase_incs[tone];
+  const u32 acc = osc->acc;
+
+  for (size_t i = 0; i < num; ++i) {
+    const s32 folded = gen_poly_phase_fold(acc + ((u32)i * inc));
+
+    // Quarter turns in Q15; the fold limits this to [-32768, 32768].
+    const s32 u = (folded + ROUND) >> 15;
+    const s32 u2 = ((u * u) + ROUND) >> 15;
+
+    s32 p = C5 + (((C7 * u2) + ROUND) >> 15);
+    p = C3 + (((p * u2) + ROUND) >> 15);
+    p = C1 + (((p * u2) + ROUND) >> 15);
+
+    const s32 sine = ((p * u) + ROUND) >> 15;
+    const s32 sample = ((sine * INT16_MAX) + ROUND) >> 15;
+
+    dst[i] = (s16)((sample > INT16_MAX) ? INT16_MAX : sample);
+  }
+  osc->acc = acc + ((u32)num * inc);
+}
+
+/// Generates a span of samples of a sine wave using the application specified
+/// generator.
+static void tone_gen_app(struct libsame_gen_ctx *const restrict ctx,
+                         union libsame_osc *const restrict osc,
+                         const uint sample_num, const enum gen_tone tone,
+                         s16 *const restrict dst, const size_t num) {
+  (void)osc;
+
+  // The application specified generator was selected without providing one;
+  // bug.
+  assert(ctx->sin_gen != NULL);
+
+  const float freq = gen_tone_freqs[tone];
+
+  for (size_t i = 0; i < num; ++i) {
+    const float t = (float)(sample_num + i) / (float)ctx->sample_rate;
+    dst[i] = ctx->sin_gen(&ctx->sin_gen_userdata, t, freq);
+  }
+}
+
+/// Generates a span of samples of a sine wave using direct digital synthesis.
+///
+/// The oscillator is a 32-bit phase accumulator advanced by the phase
+/// increment libsame_ctx_init() calculated for the tone. The upper bits of the
+/// accumulator index the sine wave lookup table and, if enabled, the next 16
+/// bits linearly interpolate between adjacent entries in fixed point.
+static void tone_gen_dds(struct libsame_gen_ctx *const restrict ctx,
+                         union libsame_osc *const restrict osc,
+                         const uint sample_num, const enum gen_tone tone,
+                         s16 *const restrict dst, const size_t num) {
+  (void)sample_num;
+  assert(osc != NULL);
+
+  const u32 inc = ctx->phase_incs[tone];
+  u32 acc = osc->acc;
+
+  for (size_t i = 0; i < num; ++i) {
+    // The table index in the upper bits, the fraction in the lower 16 bits.
+    const u32 pos = (u32)(((u64)acc * LIBSAME_CONFIG_SINE_LUT_SIZE) >> 16);
+    const u32 index = pos >> 16;
+
+#ifdef LIBSAME_CONFIG_DDS_INTERPOLATE
+    const s32 frac = (s32)(pos & UINT16_MAX);
+
+    const s32 v0 = sin_lut[index + 0];
+    const s32 v1 = sin_lut[index + 1];
+
+    dst[i] = (s16)(v0 + (((v1 - v0) * frac) >> 16));
+#else
+    dst[i] = sin_lut[index];
+#endif  // LIBSAME_CONFIG_DDS_INTERPOLATE
+
+    acc += inc;
+  }
+  osc->acc = acc;
+}
+
+/// Generates a span of samples of a sine wave by rotating a complex phasor.
+///
+/// Every sample multiplies the phasor by the unit phasor of the angle the tone
+/// advances by per sample, which libsame_ctx_init() calculated. Rounding makes
+/// the magnitude of the phasor drift over time, so before every sample number
+/// which is a multiple of ROT_RENORM_INTERVAL, including the start of every
+/// AFSK bit, it is pulled back towards one with a single Newton-Raphson step.
+/// Tying this to the sample number rather than the span keeps the output the
+/// same no matter how a tone is split into spans.
+///
+/// The phasor is kept when the tone changes, so AFSK bits switch between the
+/// mark and space frequencies without a phase discontinuity.
+static void tone_gen_rotator(struct libsame_gen_ctx *const restrict ctx,
+                             union libsame_osc *const restrict osc,
+                             const uint sample_num, const enum gen_tone tone,
+                             s16 *const restrict dst, const size_t num) {
+  assert(osc != NULL);
+
+  const float c = ctx->rot_cos[tone];
+  const float s = ctx->rot_sin[tone];
+
+  float re = osc->rot.re;
+  float im = osc->rot.im;
+
+  if ((re == 0.0F) && (im == 0.0F)) {
+    re = 1.0F;
+  }
+
+  size_t pos = 0;
+
+  while (pos < num) {
+    const size_t offset = (sample_num + pos) % ROT_RENORM_INTERVAL;
+
+    if (offset == 0) {
+      // 1/sqrt(m) ~= (3 - m) / 2 when the magnitude m is close to one.
+      const float gain = (3.0F - ((re * re) + (im * im))) * 0.5F;
+
+      re *= gain;
+      im *= gain;
+    }
+
+    const size_t block_num = ((num - pos) < (ROT_RENORM_INTERVAL - offset))
+                                 ? (num - pos)
+                                 : (ROT_RENORM_INTERVAL - offset);
+
+    for (size_t i = 0; i < block_num; ++i) {
+      dst[pos + i] = (s16)(im * INT16_MAX);
+
+      const float re_next = (re * c) - (im * s);
+      im = (re * s) + (im * c);
+      re = re_next;
+    }
+    pos += block_num;
+  }
+
+  osc->rot.re = re;
+  osc->rot.im = im;
+}
+
+/// The number of units of 2^-32 turns in one turn.
+#define TURN (4294967296.0F)
+
+/// Retrieves the phase of an oscillator of the LUT engine.
+static u32 phase_get_lut(const union libsame_osc *const osc) {
+  // The phase can sit just below zero after wrapping around.
+  return (u32)(s64)(osc->lut_phase * (TURN / LIBSAME_CONFIG_SINE_LUT_SIZE));
+}
+
+/// Moves an oscillator of the LUT engine to a phase.
+static void phase_set_lut(union libsame_osc *const osc, const u32 phase) {
+  osc->lut_phase = (float)phase * (LIBSAME_CONFIG_SINE_LUT_SIZE / TURN);
+
+  if (osc->lut_phase >= (LIBSAME_CONFIG_SINE_LUT_SIZE - 1)) {
+    osc->lut_phase -= LIBSAME_CONFIG_SINE_LUT_SIZE;
+  }
+}
+
+/// Retrieves the phase of an oscillator of the engines using 32-bit phase
+/// accumulators.
+static u32 phase_get_acc(const union libsame_osc *const osc) {
+  return osc->acc;
+}
+
+/// Moves an oscillator of the engines using 32-bit phase accumulators to a
+/// phase.
+static void phase_set_acc(union libsame_osc *const osc, const u32 phase) {
+  osc->acc = phase;
+}
+
+/// Retrieves the phase of an oscillator of the rotator engine.
+static u32 phase_get_rotator(const union libsame_osc *const osc) {
+  // atan2f(0, 0) is zero, which is also how a cleared phasor is treated.
+  const float angle = atan2f(osc->rot.im, osc->rot.re);
+  return (u32)(s64)(angle * (TURN / (PI * 2)));
+}
+
+/// Moves an oscillator of the rotator engine to a phase.
+static void phase_set_rotator(union libsame_osc *const osc, const u32 phase) {
+  const float angle = (float)phase * ((PI * 2) / TURN);
+
+  osc->rot.re = cosf(angle);
+  osc->rot.im = sinf(angle);
+}
+
+const struct gen_engine gen_engines[LIBSAME_GEN_ENGINE_NUM] = {
+    [LIBSAME_GEN_ENGINE_LIBC] = {.desc = "libc sinf()",
+                                 .tone_gen = tone_gen_libc},
+
+    [LIBSAME_GEN_ENGINE_LUT] = {.desc = "Sine wave lookup table using linear "
+                                        "interpolation and phase accumulators",
+                                .tone_gen = tone_gen_lut,
+                                .phase_get = phase_get_lut,
+                                .phase_set = phase_set_lut},
+
+    [LIBSAME_GEN_ENGINE_POLY] = {.desc = "Degree 7 minimax polynomial using "
+                                         "phase accumulators",
+                                 .tone_gen = tone_gen_poly,
+                                 .phase_get = phase_get_acc,
+                                 .phase_set = phase_set_acc},
+
+    [LIBSAME_GEN_ENGINE_APP] = {.desc = "Application specified generator",
+                                .tone_gen = tone_gen_app},
+
+    [LIBSAME_GEN_ENGINE_SIMD] = {.desc = "Degree 7 minimax polynomial, "
+                                         "vectorized with SSE2/AVX2 where "
+                                         "available",
+                                 .tone_gen = gen_engine_simd_tone_gen},
+
+    [LIBSAME_GEN_ENGINE_DDS] = {.desc = "Direct digital synthesis using 32-bit "
+                                        "integer phase accumulators and the "
+                                        "sine wave lookup table",
+                                .tone_gen = tone_gen_dds,
+                                .phase_get = phase_get_acc,
+                                .phase_set = phase_set_acc},
+
+    [LIBSAME_GEN_ENGINE_ROTATOR] = {.desc = "Complex phasor rotated by a fixed "
+                                            "angle per sample",
+                                    .tone_gen = tone_gen_rotator,
+                                    .phase_get = phase_get_rotator,
+                                    .phase_set = phase_set_rotator},
+
+    [LIBSAME_GEN_ENGINE_POLY_FIXED] = {.desc = "Degree 7 minimax polynomial "
+                                               "using phase accumulators in "
+                                               "Q15 fixed point",
+                                       .tone_gen = tone_gen_poly_fixed,
+                                       .phase_get = phase_get_acc,
+                                       .phase_set = phase_set_acc}};
+
+u32 gen_tone_phase_inc_calc(const enum gen_tone tone, const uint sample_rate) {
+  assert(tone < GEN_TONE_NUM);
+  assert(sample_rate > 0);
+
+  // Round to the nearest increment; this is the only place the rate of the
+  // tone is quantized.
+  const u64 rate_dhz = (u64)sample_rate * 10;
+  return (u32)((((u64)gen_tone_freqs_dhz[tone] << 32) + (rate_dhz / 2)) /
+               rate_dhz);
+}
+
+void gen_tone_rot_calc(const u32 phase_inc, float *const restrict rot_cos,
+                       float *const restrict rot_sin) {
+  assert(rot_cos != NULL);
+  assert(rot_sin != NULL);
+
+  // Deriving the angle from the phase increment keeps the rotator engine at
+  // exactly the same frequency as the DDS engine.
+  const float angle = (float)phase_inc * ((PI * 2) / TURN);
+
+  *rot_cos = cosf(angle);
+  *rot_sin = sinf(angle);
+}
+
+void gen_engine_lut_init(void) {
+  for (size_t sample_num = 0; sample_num < LIBSAME_CONFIG_SINE_LUT_SIZE;
+       ++sample_num) {
+    const float t = (float)sample_num / LIBSAME_CONFIG_SINE_LUT_SIZE;
+    const float sine = sinf(PI * 2 * t);
+
+    const s16 sample = (s16)(sine * INT16_MAX);
+    sin_lut[sample_num] = sample;
+  }
+  sin_lut[LIBSAME_CONFIG_SINE_LUT_SIZE] = sin_lut[0];
+}
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file gen_engine.h
+/// Defines the interface every generation engine must implement.
+///
+/// All generation engines are compiled into the library; a generation context
+/// selects the one it wants at runtime by indexing into gen_engines[] with its
+/// gen_engine member.
+
+#ifndef LIBSAME_PRIVATE_GEN_ENGINE_H
+#define LIBSAME_PRIVATE_GEN_ENGINE_H
+
+#pragma once
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+/// The host may support the AVX2 kernels; check at runtime.
+#define GEN_ENGINE_HAVE_AVX2
+#endif  // defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#include "libsame/libsame.h"
+
+/// Mark frequency is 2083.3 Hz.
+#define AFSK_MARK_FREQ (2083.3F)
+
+/// Space frequency is 1562.5 Hz.
+#define AFSK_SPACE_FREQ (1562.5F)
+
+/// The first fundamental frequency of the attention signal.
+#define ATTN_SIG_FREQ_FIRST (853.0F)
+
+/// The second fundamental frequency of the attention signal.
+#define ATTN_SIG_FREQ_SECOND (960.0F)
+
+/// Defines the tones a generation engine can be asked to produce.
+enum gen_tone {
+  /// The AFSK mark frequency.
+  GEN_TONE_AFSK_MARK,
+
+  /// The AFSK space frequency.
+  GEN_TONE_AFSK_SPACE,
+
+  /// The first fundamental frequency of the attention signal.
+  GEN_TONE_ATTN_SIG_FIRST,
+
+  /// The second fundamental frequency of the attention signal.
+  GEN_TONE_ATTN_SIG_SECOND,
+
+  /// The total number of tones. Do not modify or remove this entry.
+  GEN_TONE_NUM
+};
+
+_Static_assert(GEN_TONE_NUM == LIBSAME_TONES_NUM,
+               "The public and private tone counts must match.");
+
+/// Defines the operations a generation engine provides.
+struct gen_engine {
+  /// The full description of the generation engine.
+  const char *desc;
+
+  /// Generates a span of samples of a sine wave.
+  ///
+  /// @param ctx The generation context in use.
+  /// @param osc The oscillator for the generation. Engines which do not keep
+  ///            a phase accumulator ignore this.
+  /// @param sample_num The sample number of the first sample to generate,
+  ///                   counted from the start of the tone.
+  /// @param tone The tone to generate.
+  /// @param dst Where to store the generated samples, each multiplied by
+  ///            INT16_MAX.
+  /// @param num The number of samples to generate.
+  void (*tone_gen)(struct libsame_gen_ctx *const restrict ctx,
+                   union libsame_osc *const restrict osc,
+                   const uint sample_num, const enum gen_tone tone,
+                   s16 *const restrict dst, const size_t num);
+
+  /// Retrieves the phase of an oscillator.
+  ///
+  /// This is NULL for engines which do not keep a phase accumulator; their
+  /// phase restarts at zero on every AFSK bit.
+  ///
+  /// @param osc The oscillator to retrieve the phase of.
+  /// @returns The phase of the oscillator in units of 2^-32 turns.
+  u32 (*phase_get)(const union libsame_osc *const osc);
+
+  /// Moves an oscillator to a phase.
+  ///
+  /// This is NULL exactly when phase_get is.
+  ///
+  /// @param osc The oscillator to move.
+  /// @param phase The phase to move to in units of 2^-32 turns.
+  void (*phase_set)(union libsame_osc *const osc, const u32 phase);
+};
+
+/// The coefficients of the degree 7 odd minimax polynomial approximating
+/// sin(2 * PI * y) for y in [-0.25, 0.25] turns, with a maximum absolute error
+/// of 5.9e-7. The polynomial, SIMD and multi-message engines all evaluate it.
+#define GEN_POLY_C1 (6.283164044302505F)
+#define GEN_POLY_C3 (-41.337142371122624F)
+#define GEN_POLY_C5 (81.34076888869937F)
+#define GEN_POLY_C7 (-70.99343328277975F)
+
+/// Converts a folded phase accumulator to turns.
+#define GEN_POLY_ACC_SCALE (1.0F / 4294967296.0F)
+
+/// Folds a phase accumulator into the range [-0.25, 0.25] turns, where
+/// sin(2 * PI * x) is the same as at the original phase.
+///
+/// Phases in the second and third quadrants, where bits 31 and 30 differ, are
+/// mirrored around half a turn.
+static inline s32 gen_poly_phase_fold(const u32 acc) {
+  const u32 mirror = (acc ^ (acc << 1)) & 0x80000000U;
+  return (s32)(mirror ? (0x80000000U - acc) : acc);
+}
+
+/// Evaluates the sine polynomial for one phase.
+///
+/// @param y The phase in turns, within [-0.25, 0.25].
+/// @returns The sine wave sample multiplied by INT16_MAX.
+static inline s16 gen_poly_sample(const float y) {
+  const float y2 = y * y;
+
+  const float sine = y * (GEN_POLY_C1 +
+                          y2 * (GEN_POLY_C3 +
+                                y2 * (GEN_POLY_C5 + y2 * GEN_POLY_C7)));
+  return (s16)(sine * INT16_MAX);
+}
+
+#if defined(__SSE2__)
+/// Evaluates the sine polynomial for four phases at once.
+///
+/// @param y The phases in turns, within [-0.25, 0.25].
+/// @returns The sine wave samples multiplied by INT16_MAX.
+static inline __m128i gen_poly_sse2(const __m128 y) {
+  const __m128 y2 = _mm_mul_ps(y, y);
+
+  __m128 p = _mm_add_ps(_mm_set1_ps(GEN_POLY_C5),
+                        _mm_mul_ps(y2, _mm_set1_ps(GEN_POLY_C7)));
+  p = _mm_add_ps(_mm_set1_ps(GEN_POLY_C3), _mm_mul_ps(y2, p));
+  p = _mm_add_ps(_mm_set1_ps(GEN_POLY_C1), _mm_mul_ps(y2, p));
+  p = _mm_mul_ps(y, p);
+
+  return _mm_cvttps_epi32(_mm_mul_ps(p, _mm_set1_ps(INT16_MAX)));
+}
+#endif  // defined(__SSE2__)
+
+#ifdef GEN_ENGINE_HAVE_AVX2
+/// Evaluates the sine polynomial for eight phases at once.
+///
+/// @param y The phases in turns, within [-0.25, 0.25].
+/// @returns The sine wave samples multiplied by INT16_MAX.
+__attribute__((target("avx2"))) static inline __m256i gen_poly_avx2(
+    const __m256 y) {
+  const __m256 y2 = _mm256_mul_ps(y, y);
+
+  __m256 p = _mm256_add_ps(_mm256_set1_ps(GEN_POLY_C5),
+                           _mm256_mul_ps(y2, _mm256_set1_ps(GEN_POLY_C7)));
+  p = _mm256_add_ps(_mm256_set1_ps(GEN_POLY_C3), _mm256_mul_ps(y2, p));
+  p = _mm256_add_ps(_mm256_set1_ps(GEN_POLY_C1), _mm256_mul_ps(y2, p));
+  p = _mm256_mul_ps(y, p);
+
+  return _mm256_cvttps_epi32(_mm256_mul_ps(p, _mm256_set1_ps(INT16_MAX)));
+}
+#endif  // GEN_ENGINE_HAVE_AVX2
+
+/// The frequency of each tone in hertz.
+extern const float gen_tone_freqs[GEN_TONE_NUM];
+
+/// The frequency of each tone in tenths of a hertz. Every tone is an exact
+/// multiple of 0.1 Hz, which lets engines reduce the phase of a tone with
+/// integer arithmetic.
+extern const u32 gen_tone_freqs_dhz[GEN_TONE_NUM];
+
+/// The generation engines, indexed by enum libsame_gen_engine.
+extern const struct gen_engine gen_engines[LIBSAME_GEN_ENGINE_NUM];
+
+/// Calculates the phase increment of a tone for the DDS engine.
+///
+/// Only integer arithmetic is used.
+///
+/// @param tone The tone to calculate the phase increment of.
+/// @param sample_rate The sample rate in use.
+/// @returns The phase increment per sample in units of 2^-32 turns.
+u32 gen_tone_phase_inc_calc(const enum gen_tone tone, const uint sample_rate);
+
+/// Calculates the unit phasor the rotator engine rotates by per sample.
+///
+/// @param phase_inc The phase increment of the tone as calculated by
+///                  gen_tone_phase_inc_calc().
+/// @param rot_cos Where to store the cosine of the angle.
+/// @param rot_sin Where to store the sine of the angle.
+void gen_tone_rot_calc(const u32 phase_inc, float *const restrict rot_cos,
+                       float *const restrict rot_sin);
+
+/// Populates the sine wave lookup table used by the LUT and DDS engines.
+void gen_engine_lut_init(void);
+
+/// Selects the fastest kernel the host supports for the SIMD engine.
+void gen_engine_simd_init(void);
+
+/// Generates a span of samples of a sine wave using the SIMD engine.
+void gen_engine_simd_tone_gen(struct libsame_gen_ctx *const restrict ctx,
+                              union libsame_osc *const restrict osc,
+                              const uint sample_num, const enum gen_tone tone,
+                              s16 *const restrict dst, const size_t num);
+
+/// The number of messages the multi-message kernels generate at once.
+#define GEN_MULTI_LANES (8U)
+
+/// Defines the state of the messages the multi-message kernels generate, one
+/// lane per message.
+struct gen_multi_lanes {
+  /// The phase accumulator of the tone each lane is generating, in units of
+  /// 2^-32 turns.
+  _Alignas(32) u32 acc[GEN_MULTI_LANES];
+
+  /// The phase increment per sample of the tone each lane is generating.
+  _Alignas(32) u32 inc[GEN_MULTI_LANES];
+
+  /// The phase accumulator of the second tone of the attention signal.
+  _Alignas(32) u32 acc2[GEN_MULTI_LANES];
+
+  /// The phase increment per sample of the second tone of the attention
+  /// signal.
+  _Alignas(32) u32 inc2[GEN_MULTI_LANES];
+
+  /// All bits set for lanes generating the attention signal, clear otherwise.
+  _Alignas(32) u32 two[GEN_MULTI_LANES];
+
+  /// All bits set for lanes generating a tone, clear for lanes generating
+  /// silence.
+  _Alignas(32) u32 on[GEN_MULTI_LANES];
+};
+
+/// Selects the fastest multi-message kernel the host supports.
+void gen_engine_multi_init(void);
+
+/// Generates interleaved frames of up to GEN_MULTI_LANES messages at once.
+///
+/// The samples are identical to those the polynomial generation engine
+/// produces for the same phase accumulators and increments.
+///
+/// @param lanes The state of the messages. The phase accumulators are advanced
+///              past the generated samples.
+/// @param lanes_num The number of lanes to store.
+/// @param two_tone Whether any lane is generating the attention signal.
+/// @param dst Where to store the first lane of the first frame.
+/// @param stride The number of samples in one frame of dst.
+/// @param num The number of frames to generate.
+void gen_engine_multi_gen(struct gen_multi_lanes *const restrict lanes,
+                          const size_t lanes_num, const bool two_tone,
+                          s16 *const restrict dst, const size_t stride,
+                          const size_t num);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // LIBSAME_PRIVATE_GEN_ENGINE_H
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file gen_engine_multi.c
+/// Defines the multi-message kernels.
+///
+/// The kernels generate one sample of GEN_MULTI_LANES independent messages at
+/// a time, keeping the state of the messages as structure-of-arrays lanes, and
+/// store each sample into one frame of an interleaved buffer. The arithmetic
+/// is exactly that of the polynomial generation engine: the phase accumulator
+/// of every lane is folded into [-0.25, 0.25] turns with integer arithmetic,
+/// and the same odd degree 7 polynomial is evaluated in the same order, so
+/// every lane produces the same samples as a generation context using the
+/// polynomial generation engine would.
+///
+/// Eight lanes are processed in two registers with SSE2, and in one register
+/// with AVX2. The scalar kernel is used on hosts without either instruction
+/// set.
+
+#include <assert.h>
+#include <string.h>
+
+#include "gen_engine.h"
+
+/// Defines a multi-message kernel.
+///
+/// @param lanes The state of the messages. The phase accumulators are advanced
+///              past the generated samples.
+/// @param lanes_num The number of lanes to store.
+/// @param two_tone Whether any lane is generating the attention signal.
+/// @param dst Where to store the first lane of the first frame.
+/// @param stride The number of samples in one frame of dst.
+/// @param num The number of frames to generate.
+typedef void (*kernel_fn)(struct gen_multi_lanes *const restrict lanes,
+                          const size_t lanes_num, const bool two_tone,
+                          s16 *restrict dst, const size_t stride,
+                          const size_t num);
+
+#if !defined(__SSE2__)
+/// Generates one sample of a lane.
+static inline s32 sample_calc(const u32 acc) {
+  return gen_poly_sample((float)gen_poly_phase_fold(acc) * GEN_POLY_ACC_SCALE);
+}
+
+/// Generates samples one lane at a time.
+static void kernel_scalar(struct gen_multi_lanes *const restrict lanes,
+                          const size_t lanes_num, const bool two_tone,
+                          s16 *restrict dst, const size_t stride,
+                          const size_t num) {
+  (void)two_tone;
+
+  for (size_t i = 0; i < num; ++i) {
+    for (size_t lane = 0; lane < lanes_num; ++lane) {
+      s32 sample = sample_calc(lanes->acc[lane]);
+
+      if (lanes->two[lane]) {
+        sample = (sample / 2) + (sample_calc(lanes->acc2[lane]) / 2);
+      }
+      dst[lane] = (s16)(sample & (s32)lanes->on[lane]);
+
+      lanes->acc[lane] += lanes->inc[lane];
+      lanes->acc2[lane] += lanes->inc2[lane];
+    }
+    dst += stride;
+  }
+}
+#endif  // !defined(__SSE2__)
+
+#if defined(__SSE2__)
+/// Evaluates the sine polynomial for four phase accumulators at once.
+///
+/// @param acc The phase accumulators.
+/// @returns The generated sine wave samples multiplied by INT16_MAX.
+static inline __m128i poly_sse2(const __m128i acc) {
+  const __m128i mirror =
+      _mm_srai_epi32(_mm_xor_si128(acc, _mm_slli_epi32(acc, 1)), 31);
+
+  const __m128i folded = _mm_or_si128(
+      _mm_and_si128(mirror,
+                    _mm_sub_epi32(_mm_set1_epi32(INT32_MIN), acc)),
+      _mm_andnot_si128(mirror, acc));
+
+  return gen_poly_sse2(
+      _mm_mul_ps(_mm_cvtepi32_ps(folded), _mm_set1_ps(GEN_POLY_ACC_SCALE)));
+}
+
+/// Halves four samples, rounding towards zero.
+static inline __m128i half_sse2(const __m128i x) {
+  return _mm_srai_epi32(_mm_add_epi32(x, _mm_srli_epi32(x, 31)), 1);
+}
+
+/// Generates four lanes of one frame, then advances their phase accumulators.
+static inline __m128i lanes_gen_sse2(__m128i *const restrict acc,
+                                     __m128i *const restrict acc2,
+                                     const __m128i inc, const __m128i inc2,
+                                     const __m128i two, const __m128i on,
+                                     const bool two_tone) {
+  __m128i sample = poly_sse2(*acc);
+
+  if (two_tone) {
+    const __m128i mixed = _mm_add_epi32(half_sse2(sample),
+                                        half_sse2(poly_sse2(*acc2)));
+
+    sample = _mm_or_si128(_mm_and_si128(two, mixed),
+                          _mm_andnot_si128(two, sample));
+    *acc2 = _mm_add_epi32(*acc2, inc2);
+  }
+
+  *acc = _mm_add_epi32(*acc, inc);
+  return _mm_and_si128(sample, on);
+}
+
+/// Generates samples 8 lanes at a time using SSE2.
+static void kernel_sse2(struct gen_multi_lanes *const restrict lanes,
+                        const size_t lanes_num, const bool two_tone,
+                        s16 *restrict dst, const size_t stride,
+                        const size_t num) {
+  __m128i acc_lo = _mm_load_si128((const __m128i *)&lanes->acc[0]);
+  __m128i acc_hi = _mm_load_si128((const __m128i *)&lanes->acc[4]);
+  __m128i acc2_lo = _mm_load_si128((const __m128i *)&lanes->acc2[0]);
+  __m128i acc2_hi = _mm_load_si128((const __m128i *)&lanes->acc2[4]);
+
+  const __m128i inc_lo = _mm_load_si128((const __m128i *)&lanes->inc[0]);
+  const __m128i inc_hi = _mm_load_si128((const __m128i *)&lanes->inc[4]);
+  const __m128i inc2_lo = _mm_load_si128((const __m128i *)&lanes->inc2[0]);
+  const __m128i inc2_hi = _mm_load_si128((const __m128i *)&lanes->inc2[4]);
+  const __m128i two_lo = _mm_load_si128((const __m128i *)&lanes->two[0]);
+  const __m128i two_hi = _mm_load_si128((const __m128i *)&lanes->two[4]);
+  const __m128i on_lo = _mm_load_si128((const __m128i *)&lanes->on[0]);
+  const __m128i on_hi = _mm_load_si128((const __m128i *)&lanes->on[4]);
+
+  for (size_t i = 0; i < num; ++i) {
+    const __m128i lo = lanes_gen_sse2(&acc_lo, &acc2_lo, inc_lo, inc2_lo,
+                                      two_lo, on_lo, two_tone);
+    const __m128i hi = lanes_gen_sse2(&acc_hi, &acc2_hi, inc_hi, inc2_hi,
+                                      two_hi, on_hi, two_tone);
+
+    const __m128i frame = _mm_packs_epi32(lo, hi);
+
+    if (lanes_num == GEN_MULTI_LANES) {
+      _mm_storeu_si128((__m128i *)dst, frame);
+    } else {
+      s16 samples[GEN_MULTI_LANES];
+
+      _mm_storeu_si128((__m128i *)samples, frame);
+      memcpy(dst, samples, lanes_num * sizeof(s16));
+    }
+    dst += stride;
+  }
+
+  _mm_store_si128((__m128i *)&lanes->acc[0], acc_lo);
+  _mm_store_si128((__m128i *)&lanes->acc[4], acc_hi);
+  _mm_store_si128((__m128i *)&lanes->acc2[0], acc2_lo);
+  _mm_store_si128((__m128i *)&lanes->acc2[4], acc2_hi);
+}
+#endif  // defined(__SSE2__)
+
+#ifdef GEN_ENGINE_HAVE_AVX2
+/// Evaluates the sine polynomial for eight phase accumulators at once.
+///
+/// @param acc The phase accumulators.
+/// @returns The generated sine wave samples multiplied by INT16_MAX.
+__attribute__((target("avx2"))) static inline __m256i poly_avx2(
+    const __m256i acc) {
+  const __m256i mirror = _mm256_srai_epi32(
+      _mm256_xor_si256(acc, _mm256_slli_epi32(acc, 1)), 31);
+
+  const __m256i folded = _mm256_blendv_epi8(
+      acc, _mm256_sub_epi32(_mm256_set1_epi32(INT32_MIN), acc), mirror);
+
+  return gen_poly_avx2(_mm256_mul_ps(_mm256_cvtepi32_ps(folded),
+                                     _mm256_set1_ps(GEN_POLY_ACC_SCALE)));
+}
+
+/// Halves eight samples, rounding towards zero.
+__attribute__((target("avx2"))) static inline __m256i half_avx2(
+    const __m256i x) {
+  return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(x, 31)), 1);
+}
+
+/// Generates samples 8 lanes at a time using AVX2.
+__attribute__((target("avx2"))) static void kernel_avx2(
+    struct gen_multi_lanes *const restrict lanes, const size_t lanes_num,
+    const bool two_tone, s16 *restrict dst, const size_t stride,
+    const size_t num) {
+  __m256i acc = _mm256_load_si256((const __m256i *)lanes->acc);
+  __m256i acc2 = _mm256_load_si256((const __m256i *)lanes->acc2);
+
+  const __m256i inc = _mm256_load_si256((const __m256i *)lanes->inc);
+  const __m256i inc2 = _mm256_load_si256((const __m256i *)lanes->inc2);
+  const __m256i two = _mm256_load_si256((const __m256i *)lanes->two);
+  const __m256i on = _mm256_load_si256((const __m256i *)lanes->on);
+
+  for (size_t i = 0; i < num; ++i) {
+    __m256i sample = poly_avx2(acc);
+
+    if (two_tone) {
+      const __m256i mixed = _mm256_add_epi32(half_avx2(sample),
+                                             half_avx2(poly_avx2(acc2)));
+
+      sample = _mm256_blendv_epi8(sample, mixed, two);
+      acc2 = _mm256_add_epi32(acc2, inc2);
+    }
+
+    acc = _mm256_add_epi32(acc, inc);
+    sample = _mm256_and_si256(sample, on);
+
+    const __m128i frame =
+        _mm_packs_epi32(_mm256_castsi256_si128(sample),
+                        _mm256_extracti128_si256(sample, 1));
+
+    if (lanes_num == GEN_MULTI_LANES) {
+      _mm_storeu_si128((__m128i *)dst, frame);
+    } else {
+      s16 samples[GEN_MULTI_LANES];
+
+      _mm_storeu_si128((__m128i *)samples, frame);
+      memcpy(dst, samples, lanes_num * sizeof(s16));
+    }
+    dst += stride;
+  }
+
+  _mm256_store_si256((__m256i *)lanes->acc, acc);
+  _mm256_store_si256((__m256i *)lanes->acc2, acc2);
+}
+#endif  // GEN_ENGINE_HAVE_AVX2
+
+#if defined(__SSE2__)
+/// The multi-message kernel in use.
+static kernel_fn kernel = kernel_sse2;
+#else
+/// The multi-message kernel in use.
+static kernel_fn kernel = kernel_scalar;
+#endif  // defined(__SSE2__)
+
+void gen_engine_multi_init(void) {
+#ifdef GEN_ENGINE_HAVE_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    kernel = kernel_avx2;
+  }
+#endif  // GEN_ENGINE_HAVE_AVX2
+}
+
+void gen_engine_multi_gen(struct gen_multi_lanes *const restrict lanes,
+                          const size_t lanes_num, const bool two_tone,
+                          s16 *const restrict dst, const size_t stride,
+                          const size_t num) {
+  assert(lanes != NULL);
+  assert((lanes_num > 0) && (lanes_num <= GEN_MULTI_LANES));
+  assert(stride >= lanes_num);
+
+  kernel(lanes, lanes_num, two_tone, dst, stride, num);
+}
@@ -82,21 +82,47 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "compiler.h"
+#include "eom_cache.h"
+#include "gen_engine.h"
 #include "libsame_config.h"
+#include "sample_fmt.h"
 
-#ifdef LIBSAME_CONFIG_SINE_USE_LUT
-static s16 sin_lut[LIBSAME_CONFIG_SINE_LUT_SIZE];
-#endif  // LIBSAME_CONFIG_SINE_USE_LUT
-
-/// The value of PI up to 35 decimal places.
-#define PI (3.14159265358979323846264338327950288F)
+/// The generation engine a generation context uses unless told otherwise.
+#if defined(LIBSAME_CONFIG_SINE_USE_LIBC)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_LIBC)
+#elif defined(LIBSAME_CONFIG_SINE_USE_LUT)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_LUT)
+#elif defined(LIBSAME_CONFIG_SINE_USE_POLY)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_POLY)
+#elif defined(LIBSAME_CONFIG_SINE_USE_POLY_FIXED)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_POLY_FIXED)
+#elif defined(LIBSAME_CONFIG_SINE_USE_APP)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_APP)
+#elif defined(LIBSAME_CONFIG_SINE_USE_SIMD)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_SIMD)
+#elif defined(LIBSAME_CONFIG_SINE_USE_DDS)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_DDS)
+#elif defined(LIBSAME_CONFIG_SINE_USE_ROTATOR)
+#define GEN_ENGINE_DEFAULT (LIBSAME_GEN_ENGINE_ROTATOR)
+#else
+#error "Unknown default generation engine!"
+#endif
 
 /// The expected size of the EOM header.
 #define EOM_HEADER_SIZE (LIBSAME_PREAMBLE_NUM + 4)
 
+/// The number of samples in an AFSK header burst.
+#define HEADER_SAMPLES_NUM(ctx)                                                \
+  (AFSK_BITS_PER_CHAR * (ctx)->afsk_samples_per_bit * (ctx)->header_size)
+
+/// The number of samples in an EOM burst.
+#define EOM_SAMPLES_NUM(ctx)                                                   \
+  (AFSK_BITS_PER_CHAR * (ctx)->afsk_samples_per_bit * EOM_HEADER_SIZE)
+
 /// This is a consecutive string of bits (sixteen bytes of AB hexadecimal
 /// [8 bit byte 10101011]) sent to clear the system, set AGC and set
 /// asynchronous decoder clocking cycles. The preamble must be transmitted
@@ -107,24 +133,12 @@ static s16 sin_lut[LIBSAME_CONFIG_SINE_LUT_SIZE];
 /// of 520.83 bits per second to transmit the codes.
 #define AFSK_BIT_RATE (520.83F)
 
-// Mark frequency is 2083.3 Hz.
-#define AFSK_MARK_FREQ (2083.3F)
-
-/// Space frequency is 1562.5 Hz.
-#define AFSK_SPACE_FREQ (1562.5F)
-
 /// The number of bits in a character.
 #define AFSK_BITS_PER_CHAR (8)
 
 /// Mark and space time must be 1.92 milliseconds.
 #define AFSK_BIT_DURATION (1.0F / AFSK_BIT_RATE)
 
-/// The first fundamental frequency of the attention signal.
-#define ATTN_SIG_FREQ_FIRST (853.0F)
-
-/// The second fundamental frequency of the attention signal.
-#define ATTN_SIG_FREQ_SECOND (960.0F)
-
 /// The number of seconds one period of silence should be.
 #define SILENCE_DURATION (1)
 
@@ -134,79 +148,41 @@ static s16 sin_lut[LIBSAME_CONFIG_SINE_LUT_SIZE];
 /// The maximum duration of the attention signal in seconds.
 #define ATTN_SIG_DURATION_MAX (25)
 
-/// Generates one sample of a sine wave.
-///
-/// This function is a wrapper around the possible generation engines that may
-/// be used.
-///
-/// @param ctx The generation context in use.
-/// @param phase The phase accumulator for the generation. This can be NULL if
-///              the generation engine in use is not the LUT.
-/// @param t The time period of the sine wave.
-/// @param freq The desired frequency of the sine wave.
-/// @returns The generated sine wave sample multiplied by INT16_MAX.
-static s16 sin_gen(struct libsame_gen_ctx *const restrict ctx,
-                   float *const restrict phase, const float t,
-                   const float freq) {
-#if defined(LIBSAME_CONFIG_SINE_USE_LIBC)
-  (void)ctx;
-  (void)phase;
-  return (s16)(sinf(PI * 2 * t * freq) * INT16_MAX);
-#elif defined(LIBSAME_CONFIG_SINE_USE_LUT)
-  (void)t;
-  assert(phase != NULL);
-
-  float integral;
-  const float frac = modff(*phase, &integral);
-
-  const s16 v0 = sin_lut[(size_t)integral + 0];
-  const s16 v1 = sin_lut[(size_t)integral + 1];
-
-  const s16 sample = (s16)((float)v0 + ((float)v1 - (float)v0) * frac);
-
-  const float delta =
-      (freq * LIBSAME_CONFIG_SINE_LUT_SIZE) / (float)ctx->sample_rate;
-
-  *phase += delta;
-
-  while (*phase >= (LIBSAME_CONFIG_SINE_LUT_SIZE - 1)) {
-    *phase -= LIBSAME_CONFIG_SINE_LUT_SIZE;
-  }
-  return sample;
-#elif defined(LIBSAME_CONFIG_SINE_USE_TAYLOR)
-  (void)ctx;
-  (void)phase;
-
-  float x = PI * 2 * t * freq;
-
-  uint neg = x < 0.0F;
-  if (neg) {
-    x = -x;
-  }
-  x = fmodf(x, 2 * PI);
+/// The number of samples generated at once before being converted to an output
+/// sample format. Small enough for the block to stay in the L1 cache.
+#define SAMPLE_FMT_BLOCK_SIZE (1024U)
 
-  if (x >= PI) {
-    neg = !neg;
-    x -= PI;
-  }
+/// The most generation contexts the batch generator groups at once. Larger
+/// batches are processed in chunks of this many.
+#define BATCH_CHUNK_SIZE (64U)
 
-  // These factorials are precalculated for the low-ordered Taylor Series.
-  const float FACT_T0 = 6.0F;     // 3
-  const float FACT_T1 = 120.0F;   // 5
-  const float FACT_T2 = 5040.0F;  // 7
+/// The number of groups the batch generator sorts generation contexts into:
+/// one per kind of segment and generation engine.
+#define BATCH_GROUPS_NUM (SEGMENT_KIND_NUM * LIBSAME_GEN_ENGINE_NUM)
 
-  const float t0 = powf(x, 3) / FACT_T0;
-  const float t1 = powf(x, 5) / FACT_T1;
-  const float t2 = powf(x, 7) / FACT_T2;
+/// The number of attention signal samples mixed at once. The second tone is
+/// staged on the stack in blocks of this size before being mixed in.
+#define ATTN_SIG_BLOCK_SIZE (256U)
 
-  const float sample = (x - t0) + (t1 - t2);
-  return (s16)((neg ? -sample : sample) * INT16_MAX);
-#elif defined(LIBSAME_CONFIG_SINE_USE_APP)
-  (void)phase;
-  return ctx->sin_gen(&ctx->sin_gen_userdata, t, freq);
-#else
-#error "Unknown AFSK generation engine; implement it."
-#endif
+/// Generates a span of samples of a sine wave.
+///
+/// This function is a wrapper around the generation engine selected by the
+/// generation context.
+///
+/// @param ctx The generation context in use.
+/// @param osc The oscillator for the generation. This can be NULL if the
+///            generation engine in use does not keep a phase accumulator.
+/// @param sample_num The sample number of the first sample to generate,
+///                   counted from the start of the tone.
+/// @param tone The tone to generate.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate.
+static void tone_gen(struct libsame_gen_ctx *const restrict ctx,
+                     union libsame_osc *const restrict osc,
+                     const uint sample_num, const enum gen_tone tone,
+                     s16 *const restrict dst, const size_t num) {
+  assert(ctx->gen_engine < LIBSAME_GEN_ENGINE_NUM);
+  gen_engines[ctx->gen_engine].tone_gen(ctx, osc, sample_num, tone, dst, num);
 }
 
 /// Adds a field to the header data.
@@ -218,9 +194,9 @@ static s16 sin_gen(struct libsame_gen_ctx *const restrict ctx,
 /// @param data_size The new occupied space of the data.
 /// @param field The field to append.
 /// @param field_len The length of the field to append.
-static void field_add(u8 *const restrict data, size_t *restrict data_size,
+static void field_add(u8 *const restrict data, uint *restrict data_size,
                       const char *const restrict field,
-                      const size_t field_len) {
+                      const uint field_len) {
   assert(data != NULL);
   assert(data_size != NULL);
   assert(field != NULL);
@@ -234,98 +210,535 @@ static void field_add(u8 *const restrict data, size_t *restrict data_size,
   data[(*data_size)++] = '-';
 }
 
+/// Retrieves the AFSK bit templates a generation context can copy from.
+///
+/// @param ctx The generation context.
+/// @returns The AFSK bit templates, or NULL if none are attached or they were
+///          rendered at another sample rate or with another generation engine.
+static const struct libsame_afsk_templates *afsk_templates_get(
+    const struct libsame_gen_ctx *const ctx) {
+  const struct libsame_afsk_templates *const templates = ctx->afsk_templates;
+
+  if ((templates == NULL) || (templates->sample_rate != ctx->sample_rate) ||
+      (templates->gen_engine != ctx->gen_engine)) {
+    return NULL;
+  }
+  return templates;
+}
+
+/// Copies a span of an AFSK bit from its template.
+///
+/// The oscillator is left at the phase the bit started at until the bit is
+/// complete, then advanced by exactly the phase the bit spans; only the choice
+/// of template is rounded, so no error accumulates across bits.
+///
+/// @param ctx The generation context.
+/// @param templates The AFSK bit templates to copy from.
+/// @param tone The tone of the bit.
+/// @param dst Where to store the copied samples.
+/// @param num The number of samples to copy. This must not exceed the number of
+///            samples remaining in the bit.
+static void afsk_template_copy(
+    struct libsame_gen_ctx *const restrict ctx,
+    const struct libsame_afsk_templates *const restrict templates,
+    const enum gen_tone tone, s16 *const restrict dst, const size_t num) {
+  const struct gen_engine *const engine = &gen_engines[ctx->gen_engine];
+  const uint bit = (tone == GEN_TONE_AFSK_MARK);
+
+  u32 phase = 0;
+  uint phase_index = 0;
+
+  if (engine->phase_get != NULL) {
+    phase = engine->phase_get(&ctx->afsk.phase);
+
+    phase_index = (uint)((((u64)phase * templates->phases_num) + (1U << 31)) >>
+                         32) %
+                  templates->phases_num;
+  }
+
+  memcpy(dst, &templates->samples[bit][phase_index][ctx->afsk.sample_num],
+         num * sizeof(s16));
+
+  if ((engine->phase_set != NULL) &&
+      ((ctx->afsk.sample_num + num) >= ctx->afsk_samples_per_bit)) {
+    engine->phase_set(&ctx->afsk.phase,
+                      phase + (ctx->afsk_samples_per_bit *
+                               ctx->phase_incs[tone]));
+  }
+}
+
+/// Determines the tone of the current AFSK bit.
+///
+/// @param ctx The generation context.
+/// @param data The data the AFSK burst is generated from.
+/// @returns The tone the current bit is generated with.
+static inline enum gen_tone afsk_tone_get(
+    const struct libsame_gen_ctx *const restrict ctx,
+    const u8 *const restrict data) {
+  return ((data[ctx->afsk.data_pos] >> ctx->afsk.bit_pos) & 1)
+             ? GEN_TONE_AFSK_MARK
+             : GEN_TONE_AFSK_SPACE;
+}
+
+/// Advances the AFSK state past a span of the current bit.
+///
+/// @param ctx The generation context.
+/// @param data_size The size of the data the AFSK burst is generated from.
+/// @param span The number of samples generated. This must not exceed the
+///             number of samples remaining in the bit.
+/// @returns true if the span completed the burst.
+static bool afsk_advance(struct libsame_gen_ctx *const ctx,
+                         const size_t data_size, const size_t span) {
+  ctx->afsk.sample_num += (uint)span;
+
+  if (ctx->afsk.sample_num < ctx->afsk_samples_per_bit) {
+    return false;
+  }
+
+  ctx->afsk.sample_num = 0;
+  ctx->afsk.bit_pos++;
+
+  if (ctx->afsk.bit_pos < AFSK_BITS_PER_CHAR) {
+    return false;
+  }
+
+  ctx->afsk.bit_pos = 0;
+  ctx->afsk.data_pos++;
+
+  if (ctx->afsk.data_pos < data_size) {
+    return false;
+  }
+
+  // By the time we get here, we're completely done caring about the AFSK state
+  // for the current state; clear it to prepare for the next one.
+  memset(&ctx->afsk, 0, sizeof(ctx->afsk));
+  return true;
+}
+
 /// Generates an Audio Frequency Shift Keying (AFSK) burst.
 ///
+/// Samples are generated a bit at a time, such that the generation engine can
+/// fill the whole span of a bit in one call, or copied from the AFSK bit
+/// templates attached to the generation context.
+///
 /// @param ctx The generation context.
+/// @param templates The AFSK bit templates to copy from, or NULL to synthesize
+///                  every bit.
 /// @param data The data to generate an AFSK burst from.
 /// @param data_size The size of the data to generate an AFSK burst from.
-/// @param sample_pos The position in the sample buffer to store the sample.
-static void afsk_gen(struct libsame_gen_ctx *const restrict ctx,
-                     const u8 *const restrict data, const size_t data_size,
-                     const size_t sample_pos) {
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate. This must not exceed the
+///            number of samples remaining in the burst.
+static void afsk_gen(
+    struct libsame_gen_ctx *const restrict ctx,
+    const struct libsame_afsk_templates *const restrict templates,
+    const u8 *const restrict data, const size_t data_size, s16 *restrict dst,
+    size_t num) {
   assert(ctx != NULL);
   assert(data != NULL);
   assert(data_size > 0);
+  assert(dst != NULL);
+
+  while (num > 0) {
+    const enum gen_tone tone = afsk_tone_get(ctx, data);
+
+    const uint bit_samples_remaining =
+        ctx->afsk_samples_per_bit - ctx->afsk.sample_num;
+
+    const size_t span =
+        num < bit_samples_remaining ? num : bit_samples_remaining;
 
-  const float freq = ((data[ctx->afsk.data_pos] >> ctx->afsk.bit_pos) & 1)
-                         ? AFSK_MARK_FREQ
-                         : AFSK_SPACE_FREQ;
+    if (templates != NULL) {
+      afsk_template_copy(ctx, templates, tone, dst, span);
+    } else {
+      tone_gen(ctx, &ctx->afsk.phase, ctx->afsk.sample_num, tone, dst, span);
+    }
 
-  const float t = (float)ctx->afsk.sample_num / (float)ctx->sample_rate;
+    dst += span;
+    num -= span;
 
-  const s16 sample = sin_gen(ctx, &ctx->afsk.phase, t, freq);
+    if (afsk_advance(ctx, data_size, span)) {
+      assert(num == 0);
+    }
+  }
+}
 
-  ctx->sample_data[sample_pos] = sample;
+/// Copies a span of an AFSK burst rendered earlier.
+///
+/// @param ctx The generation context.
+/// @param src The samples of the whole burst.
+/// @param burst_num The number of samples in the burst.
+/// @param dst Where to store the copied samples.
+/// @param num The number of samples to copy. This must not exceed the number of
+///            samples remaining in the burst.
+static void afsk_burst_copy(struct libsame_gen_ctx *const restrict ctx,
+                            const s16 *const restrict src,
+                            const size_t burst_num, s16 *const restrict dst,
+                            const size_t num) {
+  const size_t remaining = ctx->seq_samples_remaining[ctx->seq_state];
+  memcpy(dst, &src[burst_num - remaining], num * sizeof(s16));
+
+  if (num == remaining) {
+    // The AFSK state may have been left mid-burst if copying only became
+    // possible after the burst started being synthesized.
+    memset(&ctx->afsk, 0, sizeof(ctx->afsk));
+  }
+}
 
-  ctx->afsk.sample_num++;
+/// Generates a span of an AFSK header burst.
+///
+/// If the generation context has a header burst buffer which can hold the
+/// whole burst, the first burst is captured in it as it is synthesized, and
+/// the second and third are copied from it once it is complete.
+///
+/// @param ctx The generation context.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate. This must not exceed the
+///            number of samples remaining in the burst.
+static void header_gen(struct libsame_gen_ctx *const restrict ctx,
+                       s16 *const restrict dst, const size_t num) {
+  const size_t burst_num = HEADER_SAMPLES_NUM(ctx);
+  s16 *const buf = (ctx->header_burst_buf_num >= burst_num)
+                       ? ctx->header_burst_buf
+                       : NULL;
+
+  if ((buf != NULL) &&
+      (ctx->seq_state != LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST) &&
+      (ctx->header_burst_captured == burst_num)) {
+    afsk_burst_copy(ctx, buf, burst_num, dst, num);
+    return;
+  }
 
-  if (ctx->afsk.sample_num >= ctx->afsk_samples_per_bit) {
-    ctx->afsk.sample_num = 0;
-    ctx->afsk.bit_pos++;
+  const size_t pos = burst_num - ctx->seq_samples_remaining[ctx->seq_state];
 
-    if (ctx->afsk.bit_pos >= AFSK_BITS_PER_CHAR) {
-      ctx->afsk.bit_pos = 0;
-      ctx->afsk.data_pos++;
+  afsk_gen(ctx, afsk_templates_get(ctx), ctx->header_data, ctx->header_size,
+           dst, num);
 
-      if (ctx->afsk.data_pos >= data_size) {
-        // By the time we get here, we're completely done caring about the AFSK
-        // state for the current state; clear it to prepare for the next one.
-        memset(&ctx->afsk, 0, sizeof(ctx->afsk));
-      }
-    }
+  if ((buf != NULL) &&
+      (ctx->seq_state == LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST) &&
+      (ctx->header_burst_captured == pos)) {
+    memcpy(&buf[pos], dst, num * sizeof(s16));
+    ctx->header_burst_captured += num;
   }
 }
 
-/// Generates a sample of silence.
+/// The End of Message header.
+static const u8 EOM_HEADER[] = {
+    PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE,
+    PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE,
+    PREAMBLE, PREAMBLE, 'N',      'N',      'N',      'N'};
+
+_Static_assert(offsetof(struct libsame_gen_ctx, sample_rate) ==
+                   LIBSAME_GEN_CTX_HOT_SIZE,
+               "The hot state of a generation context has outgrown its size");
+
+_Static_assert(sizeof(EOM_HEADER) == EOM_HEADER_SIZE,
+               "The EOM header must be EOM_HEADER_SIZE bytes.");
+
+_Static_assert((EOM_HEADER_SIZE * AFSK_BITS_PER_CHAR *
+                LIBSAME_AFSK_SAMPLES_PER_BIT_MAX) <= EOM_CACHE_SAMPLES_MAX,
+               "An EOM burst must fit in an EOM burst cache slot.");
+
+/// Renders a whole EOM burst into the EOM burst cache.
+///
+/// The AFSK state of the generation context is clear at the start of every
+/// burst and is cleared again once the burst completes, so rendering borrows
+/// it without disturbing the generation context.
+///
+/// @param ctx The generation context to render the EOM burst with.
+/// @param dst Where to store the rendered samples.
+/// @param num The number of samples in the EOM burst.
+static void eom_burst_render(struct libsame_gen_ctx *const ctx, s16 *const dst,
+                             const size_t num) {
+  afsk_gen(ctx, NULL, EOM_HEADER, EOM_HEADER_SIZE, dst, num);
+}
+
+/// Generates a span of an EOM burst.
+///
+/// The burst is copied from the EOM burst cache if possible, rendering it into
+/// the cache first at the start of a burst if it is missing. The cache holds
+/// exact syntheses, so a burst which misses it is synthesized exactly as well,
+/// ignoring any AFSK bit templates; otherwise the samples would depend on the
+/// state of the cache.
+///
+/// @param ctx The generation context.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate. This must not exceed the
+///            number of samples remaining in the burst.
+static void eom_gen(struct libsame_gen_ctx *const restrict ctx,
+                    s16 *const restrict dst, const size_t num) {
+  const size_t burst_num = EOM_SAMPLES_NUM(ctx);
+  const size_t pos = burst_num - ctx->seq_samples_remaining[ctx->seq_state];
+
+  const s16 *const cached = eom_cache_get(
+      ctx, burst_num, (pos == 0) ? eom_burst_render : NULL);
+
+  if (cached != NULL) {
+    afsk_burst_copy(ctx, cached, burst_num, dst, num);
+  } else {
+    afsk_gen(ctx, NULL, EOM_HEADER, EOM_HEADER_SIZE, dst, num);
+  }
+}
+
+/// Generates a span of silence.
 ///
 /// To configure the length of silence, adjust LIBSAME_SILENCE_DURATION to an
 /// appropriate value.
 ///
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate.
+static void silence_gen(s16 *const dst, const size_t num) {
+  assert(dst != NULL);
+  memset(dst, 0, num * sizeof(s16));
+}
+
+/// Calculates the greatest common divisor of two integers.
+static u64 gcd_calc(u64 a, u64 b) {
+  while (b != 0) {
+    const u64 r = a % b;
+
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+/// Calculates the number of samples after which the attention signal repeats
+/// exactly.
+///
+/// Each tone repeats after the smallest number of samples spanning a whole
+/// number of its periods, and the attention signal after the least common
+/// multiple of the two. Both tones are whole numbers of hertz, so this never
+/// exceeds one second.
+///
+/// @param sample_rate The sample rate in use.
+/// @returns The period of the attention signal in samples.
+static uint attn_sig_period_calc(const uint sample_rate) {
+  const u64 rate_dhz = (u64)sample_rate * 10;
+
+  const u64 first =
+      rate_dhz /
+      gcd_calc(rate_dhz, gen_tone_freqs_dhz[GEN_TONE_ATTN_SIG_FIRST]);
+
+  const u64 second =
+      rate_dhz /
+      gcd_calc(rate_dhz, gen_tone_freqs_dhz[GEN_TONE_ATTN_SIG_SECOND]);
+
+  return (uint)((first / gcd_calc(first, second)) * second);
+}
+
+/// Retrieves the attention signal tile a generation context can copy from.
+///
+/// @param ctx The generation context.
+/// @returns The attention signal tile, or NULL if none is attached or it was
+///          rendered at another sample rate or with another generation engine.
+static const struct libsame_attn_sig_tile *attn_sig_tile_get(
+    const struct libsame_gen_ctx *const ctx) {
+  const struct libsame_attn_sig_tile *const tile = ctx->attn_sig_tile;
+
+  if ((tile == NULL) || (tile->sample_rate != ctx->sample_rate) ||
+      (tile->gen_engine != ctx->gen_engine)) {
+    return NULL;
+  }
+  return tile;
+}
+
+/// Synthesizes a span of the attention signal.
+///
 /// @param ctx The generation context to use.
-/// @param sample_pos The position in the sample buffer to store the sample.
-static void silence_gen(struct libsame_gen_ctx *const ctx,
-                        const size_t sample_pos) {
-  assert(ctx != NULL);
-  ctx->sample_data[sample_pos] = 0;
+/// @param first The oscillator for the first fundamental frequency.
+/// @param second The oscillator for the second fundamental frequency.
+/// @param sample_num The sample number of the first sample to generate, counted
+///                   from the start of the attention signal.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate.
+static void attn_sig_synth(struct libsame_gen_ctx *const restrict ctx,
+                           union libsame_osc *const restrict first,
+                           union libsame_osc *const restrict second,
+                           uint sample_num, s16 *restrict dst, size_t num) {
+  s16 second_data[ATTN_SIG_BLOCK_SIZE];
+
+  while (num > 0) {
+    const size_t span = num < ATTN_SIG_BLOCK_SIZE ? num : ATTN_SIG_BLOCK_SIZE;
+
+    tone_gen(ctx, first, sample_num, GEN_TONE_ATTN_SIG_FIRST, dst, span);
+    tone_gen(ctx, second, sample_num, GEN_TONE_ATTN_SIG_SECOND, second_data,
+             span);
+
+    for (size_t i = 0; i < span; ++i) {
+      const s32 first_sample = dst[i] / (s32)sizeof(s16);
+      const s32 second_sample = second_data[i] / (s32)sizeof(s16);
+
+      dst[i] = (s16)(first_sample + second_sample);
+    }
+
+    dst += span;
+    num -= span;
+    sample_num += (uint)span;
+  }
 }
 
 /// Generates the attention signal.
 ///
+/// The attention signal is copied from the attention signal tile attached to
+/// the generation context if there is one, and synthesized otherwise.
+///
 /// @param ctx The generation context to use.
-/// @param sample_pos The position in the sample buffer to store the sample.
-static void attn_sig_gen(struct libsame_gen_ctx *const ctx,
-                         const size_t sample_pos) {
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples to generate.
+static void attn_sig_gen(struct libsame_gen_ctx *const restrict ctx,
+                         s16 *restrict dst, size_t num) {
   assert(ctx != NULL);
+  assert(dst != NULL);
 
-  const float t = (float)ctx->attn_sig_sample_num / (float)ctx->sample_rate;
+  const struct libsame_attn_sig_tile *const tile = attn_sig_tile_get(ctx);
 
-  const s32 first_sample =
-      sin_gen(ctx, &ctx->attn_sig_phase_first, t, ATTN_SIG_FREQ_FIRST) /
-      (s32)sizeof(s16);
+  if (tile == NULL) {
+    attn_sig_synth(ctx, &ctx->attn_sig_phase_first,
+                   &ctx->attn_sig_phase_second, ctx->attn_sig_sample_num, dst,
+                   num);
+    ctx->attn_sig_sample_num += (uint)num;
+    return;
+  }
+
+  while (num > 0) {
+    const uint pos = ctx->attn_sig_sample_num % tile->samples_num;
+    const size_t tile_remaining = tile->samples_num - pos;
+    const size_t span = num < tile_remaining ? num : tile_remaining;
 
-  const s32 second_sample =
-      sin_gen(ctx, &ctx->attn_sig_phase_second, t, ATTN_SIG_FREQ_SECOND) /
-      (s32)sizeof(s16);
+    memcpy(dst, &tile->samples[pos], span * sizeof(s16));
 
-  const int16_t sample = (s16)(first_sample + second_sample);
-  ctx->sample_data[sample_pos] = sample;
+    dst += span;
+    num -= span;
+    ctx->attn_sig_sample_num += (uint)span;
+  }
+}
 
-  ctx->attn_sig_sample_num++;
+/// Calculates the number of samples in a sequence state.
+///
+/// @param ctx The generation context, initialized by libsame_ctx_init().
+/// @param state The sequence state.
+/// @returns The number of samples in the sequence state.
+static uint seq_samples_num_calc(const struct libsame_gen_ctx *const ctx,
+                                 const enum libsame_seq_state state) {
+  switch (state) {
+    case LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST:
+    case LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND:
+    case LIBSAME_SEQ_STATE_AFSK_HEADER_THIRD:
+      return (uint)HEADER_SAMPLES_NUM(ctx);
+
+    case LIBSAME_SEQ_STATE_SILENCE_FIRST:
+    case LIBSAME_SEQ_STATE_SILENCE_SECOND:
+    case LIBSAME_SEQ_STATE_SILENCE_THIRD:
+    case LIBSAME_SEQ_STATE_SILENCE_FOURTH:
+    case LIBSAME_SEQ_STATE_SILENCE_FIFTH:
+    case LIBSAME_SEQ_STATE_SILENCE_SIXTH:
+    case LIBSAME_SEQ_STATE_SILENCE_SEVENTH:
+      return SILENCE_DURATION * ctx->sample_rate;
+
+    case LIBSAME_SEQ_STATE_ATTENTION_SIGNAL:
+      return ctx->attn_sig_duration * ctx->sample_rate;
+
+    case LIBSAME_SEQ_STATE_AFSK_EOM_FIRST:
+    case LIBSAME_SEQ_STATE_AFSK_EOM_SECOND:
+    case LIBSAME_SEQ_STATE_AFSK_EOM_THIRD:
+      return EOM_SAMPLES_NUM(ctx);
+
+    default:
+      UNREACHABLE;
+      return 0;
+  }
+}
+
+/// Counts the mark bits among the first bits of AFSK data.
+///
+/// @param data The AFSK data.
+/// @param bit_num The number of bits to count within.
+/// @returns The number of mark bits.
+static uint afsk_marks_count(const u8 *const data, const uint bit_num) {
+  uint marks = 0;
+
+  for (uint bit = 0; bit < bit_num; ++bit) {
+    marks += (data[bit / AFSK_BITS_PER_CHAR] >> (bit % AFSK_BITS_PER_CHAR)) & 1;
+  }
+  return marks;
+}
+
+/// Moves the AFSK state to a sample position within an AFSK burst.
+///
+/// The phase of the oscillator is the phase each previous bit advanced it by,
+/// plus the phase the current bit has advanced it by so far unless AFSK bit
+/// templates are in use; those only advance it once a bit completes.
+///
+/// @param ctx The generation context.
+/// @param data The data the AFSK burst is generated from.
+/// @param pos The sample position within the burst.
+static void afsk_seek(struct libsame_gen_ctx *const restrict ctx,
+                      const u8 *const restrict data, const uint pos) {
+  const struct gen_engine *const engine = &gen_engines[ctx->gen_engine];
+  const uint bit = pos / ctx->afsk_samples_per_bit;
+
+  ctx->afsk.data_pos = bit / AFSK_BITS_PER_CHAR;
+  ctx->afsk.bit_pos = bit % AFSK_BITS_PER_CHAR;
+  ctx->afsk.sample_num = pos % ctx->afsk_samples_per_bit;
+
+  if (engine->phase_set == NULL) {
+    return;
+  }
+
+  const uint marks = afsk_marks_count(data, bit);
+  const uint spaces = bit - marks;
+
+  u32 phase = ctx->afsk_samples_per_bit *
+              ((marks * ctx->phase_incs[GEN_TONE_AFSK_MARK]) +
+               (spaces * ctx->phase_incs[GEN_TONE_AFSK_SPACE]));
+
+  if (afsk_templates_get(ctx) == NULL) {
+    const enum gen_tone tone = afsk_tone_get(ctx, data);
+    phase += ctx->afsk.sample_num * ctx->phase_incs[tone];
+  }
+  engine->phase_set(&ctx->afsk.phase, phase);
+}
+
+/// Moves the attention signal state to a sample position within the attention
+/// signal.
+///
+/// @param ctx The generation context.
+/// @param pos The sample position within the attention signal.
+static void attn_sig_seek(struct libsame_gen_ctx *const ctx, const uint pos) {
+  const struct gen_engine *const engine = &gen_engines[ctx->gen_engine];
+
+  ctx->attn_sig_sample_num = pos;
+
+  if (engine->phase_set != NULL) {
+    engine->phase_set(&ctx->attn_sig_phase_first,
+                      pos * ctx->phase_incs[GEN_TONE_ATTN_SIG_FIRST]);
+    engine->phase_set(&ctx->attn_sig_phase_second,
+                      pos * ctx->phase_incs[GEN_TONE_ATTN_SIG_SECOND]);
+  }
+}
+
+/// Calculates the unit phasors the rotator engine rotates each tone by.
+///
+/// These cost a cosf() and a sinf() call per tone, so they are calculated only
+/// when the rotator engine is selected rather than by every initialization.
+///
+/// @param ctx The generation context.
+static void rot_tables_calc(struct libsame_gen_ctx *const ctx) {
+  assert(ctx != NULL);
+
+  for (size_t tone = 0; tone < GEN_TONE_NUM; ++tone) {
+    gen_tone_rot_calc(ctx->phase_incs[tone], &ctx->rot_cos[tone],
+                      &ctx->rot_sin[tone]);
+  }
 }
 
 /// Initializes libsame for use. This must be called before any context is
 /// created and used.
 void libsame_init(void) {
-#ifdef LIBSAME_CONFIG_SINE_USE_LUT
-  for (size_t sample_num = 0; sample_num < LIBSAME_CONFIG_SINE_LUT_SIZE;
-       ++sample_num) {
-    const float t = (float)sample_num / LIBSAME_CONFIG_SINE_LUT_SIZE;
-    const float sine = sinf(PI * 2 * t);
-
-    const s16 sample = (s16)(sine * INT16_MAX);
-    sin_lut[sample_num] = sample;
-  }
-#endif  // LIBSAME_CONFIG_SINE_USE_LUT
+  gen_engine_lut_init();
+  gen_engine_simd_init();
+  gen_engine_multi_init();
 }
 
 /// Configures a generation context to generate the specified header.
@@ -354,6 +767,13 @@ void libsame_ctx_init(struct libsame_gen_ctx *const restrict ctx,
          sizeof(LIBSAME_INITIAL_HEADER));
 
   ctx->sample_rate = sample_rate;
+  ctx->attn_sig_duration = header->attn_sig_duration;
+  ctx->gen_engine = GEN_ENGINE_DEFAULT;
+  ctx->afsk_templates = NULL;
+  ctx->attn_sig_tile = NULL;
+  ctx->header_burst_buf = NULL;
+  ctx->header_burst_buf_num = 0;
+  ctx->header_burst_captured = 0;
 
   // We want to start populating the fields after the first dash.
   ctx->header_size = LIBSAME_PREAMBLE_NUM + LIBSAME_ASCII_ID_LEN + 1;
@@ -385,31 +805,121 @@ void libsame_ctx_init(struct libsame_gen_ctx *const restrict ctx,
   ctx->afsk_samples_per_bit =
       (uint)roundf(AFSK_BIT_DURATION * (float)ctx->sample_rate);
 
-  // clang-format off
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_THIRD] =
-  AFSK_BITS_PER_CHAR * ctx->afsk_samples_per_bit *
-  (uint)ctx->header_size;
-
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_EOM_FIRST] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_EOM_SECOND] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_EOM_THIRD] =
-  AFSK_BITS_PER_CHAR * ctx->afsk_samples_per_bit *
-  EOM_HEADER_SIZE;
-
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_FIRST] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_SECOND] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_THIRD] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_FOURTH] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_FIFTH] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_SIXTH] =
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_SILENCE_SEVENTH] =
-  SILENCE_DURATION * ctx->sample_rate;
-
-  ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_ATTENTION_SIGNAL] =
-  header->attn_sig_duration * ctx->sample_rate;
-  // clang-format on
+  for (size_t tone = 0; tone < GEN_TONE_NUM; ++tone) {
+    ctx->phase_incs[tone] =
+        gen_tone_phase_inc_calc((enum gen_tone)tone, ctx->sample_rate);
+  }
+
+  if (ctx->gen_engine == LIBSAME_GEN_ENGINE_ROTATOR) {
+    rot_tables_calc(ctx);
+  }
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    ctx->seq_samples_remaining[state] =
+        seq_samples_num_calc(ctx, (enum libsame_seq_state)state);
+  }
+}
+
+/// Defines the kinds of segment a message is made of. Every state of the same
+/// kind is generated by the same function.
+enum segment_kind {
+  /// An AFSK header burst.
+  SEGMENT_KIND_HEADER,
+
+  /// One second of silence.
+  SEGMENT_KIND_SILENCE,
+
+  /// The attention signal.
+  SEGMENT_KIND_ATTN_SIG,
+
+  /// An AFSK EOM burst.
+  SEGMENT_KIND_EOM,
+
+  /// The total number of segment kinds. Do not modify or remove this entry.
+  SEGMENT_KIND_NUM
+};
+
+/// The kind of segment each state generates.
+static const u8 segment_kinds[LIBSAME_SEQ_STATE_NUM] = {
+    [LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST] = SEGMENT_KIND_HEADER,
+    [LIBSAME_SEQ_STATE_SILENCE_FIRST] = SEGMENT_KIND_SILENCE,
+    [LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND] = SEGMENT_KIND_HEADER,
+    [LIBSAME_SEQ_STATE_SILENCE_SECOND] = SEGMENT_KIND_SILENCE,
+    [LIBSAME_SEQ_STATE_AFSK_HEADER_THIRD] = SEGMENT_KIND_HEADER,
+    [LIBSAME_SEQ_STATE_SILENCE_THIRD] = SEGMENT_KIND_SILENCE,
+    [LIBSAME_SEQ_STATE_ATTENTION_SIGNAL] = SEGMENT_KIND_ATTN_SIG,
+    [LIBSAME_SEQ_STATE_SILENCE_FOURTH] = SEGMENT_KIND_SILENCE,
+    [LIBSAME_SEQ_STATE_AFSK_EOM_FIRST] = SEGMENT_KIND_EOM,
+    [LIBSAME_SEQ_STATE_SILENCE_FIFTH] = SEGMENT_KIND_SILENCE,
+    [LIBSAME_SEQ_STATE_AFSK_EOM_SECOND] = SEGMENT_KIND_EOM,
+    [LIBSAME_SEQ_STATE_SILENCE_SIXTH] = SEGMENT_KIND_SILENCE,
+    [LIBSAME_SEQ_STATE_AFSK_EOM_THIRD] = SEGMENT_KIND_EOM,
+    [LIBSAME_SEQ_STATE_SILENCE_SEVENTH] = SEGMENT_KIND_SILENCE};
+
+/// Generates a run of the current segment of a generation context, then
+/// advances the sequence past the run.
+///
+/// @param ctx The generation context.
+/// @param kind The kind of the current segment.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples dst can hold.
+/// @returns The number of samples generated, which is num or the rest of the
+///          segment, whichever is fewer.
+static inline size_t segment_run_gen(struct libsame_gen_ctx *const restrict ctx,
+                                     const enum segment_kind kind,
+                                     s16 *const restrict dst,
+                                     const size_t num) {
+  const size_t run = ctx->seq_samples_remaining[ctx->seq_state] < num
+                         ? ctx->seq_samples_remaining[ctx->seq_state]
+                         : num;
+
+  switch (kind) {
+    case SEGMENT_KIND_HEADER:
+      header_gen(ctx, dst, run);
+      break;
+
+    case SEGMENT_KIND_SILENCE:
+      silence_gen(dst, run);
+      break;
+
+    case SEGMENT_KIND_ATTN_SIG:
+      attn_sig_gen(ctx, dst, run);
+      break;
+
+    case SEGMENT_KIND_EOM:
+      eom_gen(ctx, dst, run);
+      break;
+
+    default:
+      UNREACHABLE;
+      break;
+  }
+  ctx->seq_samples_remaining[ctx->seq_state] -= (uint)run;
+
+  if (ctx->seq_samples_remaining[ctx->seq_state] == 0) {
+    ctx->seq_state++;
+  }
+  return run;
+}
+
+/// Generates the audio samples for the SAME header into a span.
+///
+/// Every state is generated as a segment spanning the rest of the state or the
+/// rest of the span, whichever ends first.
+///
+/// @param ctx The generation context.
+/// @param dst Where to store the generated samples.
+/// @param num The number of samples dst can hold.
+/// @returns The number of samples generated.
+static size_t segments_gen(struct libsame_gen_ctx *const restrict ctx,
+                           s16 *const restrict dst, const size_t num) {
+  size_t sample_count = 0;
+
+  while ((sample_count < num) && (ctx->seq_state < LIBSAME_SEQ_STATE_NUM)) {
+    sample_count += segment_run_gen(ctx, segment_kinds[ctx->seq_state],
+                                    &dst[sample_count], num - sample_count);
+  }
+  return sample_count;
 }
 
 /// Generates the audio samples for the SAME header using the specified
@@ -419,93 +929,598 @@ void libsame_ctx_init(struct libsame_gen_ctx *const restrict ctx,
 /// libsame_ctx_init() before calling this function.
 ///
 /// @param ctx The generation context.
-void libsame_samples_gen(struct libsame_gen_ctx *const ctx) {
+/// @param dst Where to store the generated samples. This must hold
+///            LIBSAME_SAMPLES_NUM_MAX samples; once the end of the sequence is
+///            reached, the samples past it are left untouched.
+void libsame_samples_gen(struct libsame_gen_ctx *const restrict ctx,
+                         s16 *const restrict dst) {
   assert(ctx != NULL);
-
-  static const u8 EOM_HEADER[] = {
-      PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE,
-      PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE, PREAMBLE,
-      PREAMBLE, PREAMBLE, 'N',      'N',      'N',      'N'};
+  assert(dst != NULL);
 
   // Tried to generate a SAME header using a context for which a SAME header was
   // already generated; bug.
   assert(ctx->seq_state < LIBSAME_SEQ_STATE_NUM);
 
-  for (uint sample_count = 0; sample_count < LIBSAME_SAMPLES_NUM_MAX;
-       ++sample_count) {
-    switch (ctx->seq_state) {
-      case LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST:
-      case LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND:
-      case LIBSAME_SEQ_STATE_AFSK_HEADER_THIRD:
-        afsk_gen(ctx, ctx->header_data, ctx->header_size, sample_count);
-        break;
+  segments_gen(ctx, dst, LIBSAME_SAMPLES_NUM_MAX);
+}
 
-      case LIBSAME_SEQ_STATE_SILENCE_FIRST:
-      case LIBSAME_SEQ_STATE_SILENCE_SECOND:
-      case LIBSAME_SEQ_STATE_SILENCE_THIRD:
-      case LIBSAME_SEQ_STATE_SILENCE_FOURTH:
-      case LIBSAME_SEQ_STATE_SILENCE_FIFTH:
-      case LIBSAME_SEQ_STATE_SILENCE_SIXTH:
-      case LIBSAME_SEQ_STATE_SILENCE_SEVENTH:
-        silence_gen(ctx, sample_count);
-        break;
+size_t libsame_samples_gen_buf(struct libsame_gen_ctx *const restrict ctx,
+                               s16 *const restrict dst, const size_t num) {
+  assert(ctx != NULL);
+  assert((dst != NULL) || (num == 0));
+  assert(ctx->seq_state <= LIBSAME_SEQ_STATE_NUM);
 
-      case LIBSAME_SEQ_STATE_ATTENTION_SIGNAL:
-        attn_sig_gen(ctx, sample_count);
-        break;
+  return segments_gen(ctx, dst, num);
+}
 
-      case LIBSAME_SEQ_STATE_AFSK_EOM_FIRST:
-      case LIBSAME_SEQ_STATE_AFSK_EOM_SECOND:
-      case LIBSAME_SEQ_STATE_AFSK_EOM_THIRD:
-        afsk_gen(ctx, EOM_HEADER, EOM_HEADER_SIZE, sample_count);
+size_t libsame_samples_gen_batch(struct libsame_gen_ctx *const *const ctxs,
+                                 const size_t ctxs_num, s16 *const dst,
+                                 const size_t num, size_t *const generated) {
+  assert((ctxs != NULL) || (ctxs_num == 0));
+  assert((dst != NULL) || (num == 0) || (ctxs_num == 0));
+
+  size_t total = 0;
+
+  for (size_t base = 0; base < ctxs_num; base += BATCH_CHUNK_SIZE) {
+    const size_t chunk_num = ((ctxs_num - base) < BATCH_CHUNK_SIZE)
+                                 ? (ctxs_num - base)
+                                 : BATCH_CHUNK_SIZE;
+
+    size_t counts[BATCH_CHUNK_SIZE] = {0};
+
+    // Every round generates one run of each unfinished context, grouped by
+    // the kind of segment it is in and then by its generation engine, until
+    // every span is full or every sequence has ended. A context can only
+    // cross one segment boundary per round, so there are few rounds.
+    for (;;) {
+      u8 groups[BATCH_CHUNK_SIZE];
+      u8 order[BATCH_CHUNK_SIZE];
+      size_t group_starts[BATCH_GROUPS_NUM + 1] = {0};
+      size_t active_num = 0;
+
+      for (size_t i = 0; i < chunk_num; ++i) {
+        const struct libsame_gen_ctx *const ctx = ctxs[base + i];
+
+        assert(ctx != NULL);
+        assert(ctx->seq_state <= LIBSAME_SEQ_STATE_NUM);
+
+        groups[i] = BATCH_GROUPS_NUM;
+
+        if ((counts[i] < num) && (ctx->seq_state < LIBSAME_SEQ_STATE_NUM)) {
+          groups[i] = (u8)((segment_kinds[ctx->seq_state] *
+                            LIBSAME_GEN_ENGINE_NUM) +
+                           ctx->gen_engine);
+          group_starts[groups[i] + 1]++;
+          active_num++;
+        }
+      }
+
+      if (active_num == 0) {
         break;
+      }
+
+      // Counting sort the unfinished contexts by group, keeping their order
+      // within each group.
+      for (size_t group = 0; group < BATCH_GROUPS_NUM; ++group) {
+        group_starts[group + 1] += group_starts[group];
+      }
+
+      for (size_t i = 0; i < chunk_num; ++i) {
+        if (groups[i] < BATCH_GROUPS_NUM) {
+          order[group_starts[groups[i]]++] = (u8)i;
+        }
+      }
+
+      for (size_t m = 0; m < active_num; ++m) {
+        const size_t i = order[m];
+        const enum segment_kind kind =
+            (enum segment_kind)(groups[i] / LIBSAME_GEN_ENGINE_NUM);
+
+        counts[i] += segment_run_gen(ctxs[base + i], kind,
+                                     &dst[((base + i) * num) + counts[i]],
+                                     num - counts[i]);
+      }
+    }
+
+    for (size_t i = 0; i < chunk_num; ++i) {
+      if (generated != NULL) {
+        generated[base + i] = counts[i];
+      }
+      total += counts[i];
+    }
+  }
+  return total;
+}
+
+/// Loads the state of a generation context into a lane of the multi-message
+/// kernels.
+///
+/// @param ctx The generation context.
+/// @param lanes The lanes of the multi-message kernels.
+/// @param lane The lane to load into.
+/// @returns The number of samples the lane can be generated for before the
+///          state of the generation context must be advanced: the rest of the
+///          current AFSK bit or segment, or zero once the sequence has ended.
+static size_t multi_lane_load(struct libsame_gen_ctx *const restrict ctx,
+                              struct gen_multi_lanes *const restrict lanes,
+                              const size_t lane) {
+  lanes->acc[lane] = 0;
+  lanes->inc[lane] = 0;
+  lanes->acc2[lane] = 0;
+  lanes->inc2[lane] = 0;
+  lanes->two[lane] = 0;
+  lanes->on[lane] = 0;
+
+  if (ctx->seq_state >= LIBSAME_SEQ_STATE_NUM) {
+    return 0;
+  }
+
+  const uint remaining = ctx->seq_samples_remaining[ctx->seq_state];
+  const enum segment_kind kind = segment_kinds[ctx->seq_state];
+
+  switch (kind) {
+    case SEGMENT_KIND_HEADER:
+    case SEGMENT_KIND_EOM: {
+      const bool header = (kind == SEGMENT_KIND_HEADER);
+      const u8 *const data = header ? ctx->header_data : EOM_HEADER;
+      const uint burst_num = (uint)(header ? HEADER_SAMPLES_NUM(ctx)
+                                           : EOM_SAMPLES_NUM(ctx));
+
+      const uint pos = burst_num - remaining;
+      const uint afsk_pos =
+          (((uint)(ctx->afsk.data_pos * AFSK_BITS_PER_CHAR) +
+            ctx->afsk.bit_pos) *
+           ctx->afsk_samples_per_bit) +
+          ctx->afsk.sample_num;
+
+      // Bursts copied from a buffer do not advance the AFSK state; catch up
+      // with the sequence if one was copied from part of the way.
+      if (afsk_pos != pos) {
+        afsk_seek(ctx, data, pos);
+      }
+
+      const enum gen_tone tone = afsk_tone_get(ctx, data);
+      const uint bit_remaining =
+          ctx->afsk_samples_per_bit - ctx->afsk.sample_num;
+
+      lanes->acc[lane] = ctx->afsk.phase.acc;
+      lanes->inc[lane] = ctx->phase_incs[tone];
+      lanes->on[lane] = UINT32_MAX;
+
+      return (bit_remaining < remaining) ? bit_remaining : remaining;
+    }
+
+    case SEGMENT_KIND_SILENCE:
+      return remaining;
+
+    case SEGMENT_KIND_ATTN_SIG:
+      lanes->acc[lane] = ctx->attn_sig_phase_first.acc;
+      lanes->inc[lane] = ctx->phase_incs[GEN_TONE_ATTN_SIG_FIRST];
+      lanes->acc2[lane] = ctx->attn_sig_phase_second.acc;
+      lanes->inc2[lane] = ctx->phase_incs[GEN_TONE_ATTN_SIG_SECOND];
+      lanes->two[lane] = UINT32_MAX;
+      lanes->on[lane] = UINT32_MAX;
+      return remaining;
+
+    default:
+      UNREACHABLE;
+      return 0;
+  }
+}
+
+/// Advances the state of a generation context past a span generated by the
+/// multi-message kernels.
+///
+/// @param ctx The generation context.
+/// @param lanes The lanes of the multi-message kernels.
+/// @param lane The lane the generation context was loaded into.
+/// @param span The number of samples generated. This must not exceed the
+///             number multi_lane_load() returned.
+static void multi_lane_advance(struct libsame_gen_ctx *const restrict ctx,
+                               const struct gen_multi_lanes *const restrict
+                                   lanes,
+                               const size_t lane, const size_t span) {
+  switch (segment_kinds[ctx->seq_state]) {
+    case SEGMENT_KIND_HEADER:
+      ctx->afsk.phase.acc = lanes->acc[lane];
+      afsk_advance(ctx, ctx->header_size, span);
+      break;
+
+    case SEGMENT_KIND_EOM:
+      ctx->afsk.phase.acc = lanes->acc[lane];
+      afsk_advance(ctx, EOM_HEADER_SIZE, span);
+      break;
 
-      default:
-        UNREACHABLE;
+    case SEGMENT_KIND_ATTN_SIG:
+      ctx->attn_sig_phase_first.acc = lanes->acc[lane];
+      ctx->attn_sig_phase_second.acc = lanes->acc2[lane];
+      ctx->attn_sig_sample_num += (uint)span;
+      break;
+
+    case SEGMENT_KIND_SILENCE:
+      break;
+
+    default:
+      UNREACHABLE;
+      break;
+  }
+  ctx->seq_samples_remaining[ctx->seq_state] -= (uint)span;
+
+  if (ctx->seq_samples_remaining[ctx->seq_state] == 0) {
+    ctx->seq_state++;
+  }
+}
+
+/// Generates one lane of the multi-message output through the scalar
+/// generation path, for generation contexts whose engine the multi-message
+/// kernels do not implement.
+///
+/// @param ctx The generation context.
+/// @param dst The first sample of the lane.
+/// @param stride The distance between consecutive samples of the lane.
+/// @param num The number of samples to generate. Samples past the end of the
+///            sequence are zeroed.
+/// @returns The number of samples generated.
+static size_t multi_lane_scalar_gen(struct libsame_gen_ctx *const restrict ctx,
+                                    s16 *const restrict dst,
+                                    const size_t stride, const size_t num) {
+  s16 block[SAMPLE_FMT_BLOCK_SIZE];
+  size_t sample_count = 0;
+
+  while (sample_count < num) {
+    const size_t block_max = num - sample_count;
+    const size_t block_num =
+        block_max < SAMPLE_FMT_BLOCK_SIZE ? block_max : SAMPLE_FMT_BLOCK_SIZE;
+
+    const size_t generated = segments_gen(ctx, block, block_num);
+
+    for (size_t i = 0; i < generated; ++i) {
+      dst[(sample_count + i) * stride] = block[i];
+    }
+    sample_count += generated;
+
+    if (generated < block_num) {
+      break;
+    }
+  }
+
+  for (size_t i = sample_count; i < num; ++i) {
+    dst[i * stride] = 0;
+  }
+  return sample_count;
+}
+
+size_t libsame_samples_gen_multi(struct libsame_gen_ctx *const *const ctxs,
+                                 const size_t ctxs_num, s16 *const dst,
+                                 const size_t num, size_t *const generated) {
+  assert((ctxs != NULL) || (ctxs_num == 0));
+  assert((dst != NULL) || (num == 0) || (ctxs_num == 0));
+
+  size_t total = 0;
+
+  for (size_t base = 0; base < ctxs_num; base += GEN_MULTI_LANES) {
+    const size_t lanes_num = ((ctxs_num - base) < GEN_MULTI_LANES)
+                                 ? (ctxs_num - base)
+                                 : GEN_MULTI_LANES;
+
+    struct gen_multi_lanes lanes = {0};
+    size_t runs[GEN_MULTI_LANES] = {0};
+    size_t counts[GEN_MULTI_LANES] = {0};
+    bool scalar[GEN_MULTI_LANES] = {false};
+
+    for (size_t lane = 0; lane < lanes_num; ++lane) {
+      struct libsame_gen_ctx *const ctx = ctxs[base + lane];
+
+      assert(ctx != NULL);
+      assert(ctx->gen_engine < LIBSAME_GEN_ENGINE_NUM);
+      assert(ctx->seq_state <= LIBSAME_SEQ_STATE_NUM);
+
+      // The kernels only implement the polynomial engine; other lanes stay
+      // silent here and are generated one at a time afterwards.
+      if (ctx->gen_engine != LIBSAME_GEN_ENGINE_POLY) {
+        scalar[lane] = true;
+        continue;
+      }
+      runs[lane] = multi_lane_load(ctx, &lanes, lane);
+    }
+
+    // Every step generates every lane up to the nearest point where one of
+    // them must be advanced: the end of an AFSK bit or of a segment.
+    size_t frame = 0;
+
+    while (frame < num) {
+      size_t span = num - frame;
+      bool active = false;
+      bool two_tone = false;
+
+      for (size_t lane = 0; lane < lanes_num; ++lane) {
+        if (runs[lane] > 0) {
+          span = (runs[lane] < span) ? runs[lane] : span;
+          two_tone |= (lanes.two[lane] != 0);
+          active = true;
+        }
+      }
+
+      if (!active) {
         break;
+      }
+
+      gen_engine_multi_gen(&lanes, lanes_num, two_tone,
+                           &dst[(frame * ctxs_num) + base], ctxs_num, span);
+      frame += span;
+
+      for (size_t lane = 0; lane < lanes_num; ++lane) {
+        if (runs[lane] == 0) {
+          continue;
+        }
+
+        struct libsame_gen_ctx *const ctx = ctxs[base + lane];
+
+        multi_lane_advance(ctx, &lanes, lane, span);
+        counts[lane] += span;
+        runs[lane] -= span;
+
+        if (runs[lane] == 0) {
+          runs[lane] = multi_lane_load(ctx, &lanes, lane);
+        }
+      }
+    }
+
+    for (; frame < num; ++frame) {
+      memset(&dst[(frame * ctxs_num) + base], 0, lanes_num * sizeof(s16));
+    }
+
+    for (size_t lane = 0; lane < lanes_num; ++lane) {
+      if (scalar[lane]) {
+        counts[lane] = multi_lane_scalar_gen(
+            ctxs[base + lane], &dst[base + lane], ctxs_num, num);
+      }
+
+      if (generated != NULL) {
+        generated[base + lane] = counts[lane];
+      }
+      total += counts[lane];
+    }
+  }
+  return total;
+}
+
+size_t libsame_samples_gen_fmt(struct libsame_gen_ctx *const restrict ctx,
+                               const enum libsame_sample_fmt fmt,
+                               void *const restrict dst, const size_t num) {
+  return libsame_samples_gen_strided(ctx, fmt, dst, num, 1, 1);
+}
+
+size_t libsame_samples_gen_strided(struct libsame_gen_ctx *const restrict ctx,
+                                   const enum libsame_sample_fmt fmt,
+                                   void *const restrict dst, const size_t num,
+                                   const size_t stride, const size_t channels) {
+  assert(ctx != NULL);
+  assert(fmt < LIBSAME_SAMPLE_FMT_NUM);
+  assert((dst != NULL) || (num == 0));
+  assert(ctx->seq_state <= LIBSAME_SEQ_STATE_NUM);
+  assert(channels > 0);
+  assert(channels <= stride);
+
+  const size_t frame_size = stride * sample_fmts[fmt].size;
+  u8 *out = dst;
+  size_t sample_count = 0;
+
+  s16 block[SAMPLE_FMT_BLOCK_SIZE];
+
+  while (sample_count < num) {
+    const size_t block_max = num - sample_count;
+    const size_t block_num =
+        block_max < SAMPLE_FMT_BLOCK_SIZE ? block_max : SAMPLE_FMT_BLOCK_SIZE;
+
+    const size_t generated = segments_gen(ctx, block, block_num);
+    sample_fmt_write(fmt, block, out, generated, stride, channels);
+
+    out += generated * frame_size;
+    sample_count += generated;
+
+    if (generated < block_num) {
+      break;
+    }
+  }
+  return sample_count;
+}
+
+size_t libsame_sample_fmt_size_get(const enum libsame_sample_fmt fmt) {
+  assert(fmt < LIBSAME_SAMPLE_FMT_NUM);
+  return sample_fmts[fmt].size;
+}
+
+void libsame_segment_map_get(struct libsame_segment_map *const restrict map,
+                             const struct libsame_header *const restrict header,
+                             const uint sample_rate) {
+  assert(map != NULL);
+  assert(header != NULL);
+
+  // Only the lengths libsame_ctx_init() calculates are needed, and a
+  // generation context holds no audio samples, so a temporary one is cheap.
+  struct libsame_gen_ctx ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, header, sample_rate);
+
+  map->samples_num = 0;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    struct libsame_segment *const segment = &map->segments[state];
+
+    segment->state = (enum libsame_seq_state)state;
+    segment->start = map->samples_num;
+    segment->num = ctx.seq_samples_remaining[state];
+
+    map->samples_num += segment->num;
+  }
+}
+
+void libsame_seek(struct libsame_gen_ctx *const ctx, size_t sample_pos) {
+  assert(ctx != NULL);
+  assert(ctx->gen_engine < LIBSAME_GEN_ENGINE_NUM);
+
+  memset(&ctx->afsk, 0, sizeof(ctx->afsk));
+  memset(&ctx->attn_sig_phase_first, 0, sizeof(ctx->attn_sig_phase_first));
+  memset(&ctx->attn_sig_phase_second, 0, sizeof(ctx->attn_sig_phase_second));
+  ctx->attn_sig_sample_num = 0;
+
+  // A partially captured header burst can only be resumed from where the
+  // capture left off, so start over.
+  if (ctx->header_burst_captured != HEADER_SAMPLES_NUM(ctx)) {
+    ctx->header_burst_captured = 0;
+  }
+
+  ctx->seq_state = LIBSAME_SEQ_STATE_NUM;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    const uint num = seq_samples_num_calc(ctx, (enum libsame_seq_state)state);
+
+    if (ctx->seq_state != LIBSAME_SEQ_STATE_NUM) {
+      ctx->seq_samples_remaining[state] = num;
+    } else if (sample_pos < num) {
+      ctx->seq_state = (enum libsame_seq_state)state;
+      ctx->seq_samples_remaining[state] = num - (uint)sample_pos;
+    } else {
+      ctx->seq_samples_remaining[state] = 0;
+      sample_pos -= num;
     }
-    ctx->seq_samples_remaining[ctx->seq_state]--;
+  }
 
-    if (ctx->seq_samples_remaining[ctx->seq_state] == 0) {
-      ctx->seq_state++;
+  switch (ctx->seq_state) {
+    case LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST:
+    case LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND:
+    case LIBSAME_SEQ_STATE_AFSK_HEADER_THIRD:
+      afsk_seek(ctx, ctx->header_data, (uint)sample_pos);
+      break;
+
+    case LIBSAME_SEQ_STATE_ATTENTION_SIGNAL:
+      attn_sig_seek(ctx, (uint)sample_pos);
+      break;
 
-      if (ctx->seq_state >= LIBSAME_SEQ_STATE_NUM) {
-        return;
+    case LIBSAME_SEQ_STATE_AFSK_EOM_FIRST:
+    case LIBSAME_SEQ_STATE_AFSK_EOM_SECOND:
+    case LIBSAME_SEQ_STATE_AFSK_EOM_THIRD:
+      afsk_seek(ctx, EOM_HEADER, (uint)sample_pos);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/// Selects the generation engine a generation context uses.
+///
+/// The generation context *MUST* have been initialized by using
+/// libsame_ctx_init() before calling this function, as libsame_ctx_init()
+/// resets the generation engine to the default one.
+///
+/// @param ctx The generation context.
+/// @param engine The generation engine to use.
+void libsame_ctx_gen_engine_set(struct libsame_gen_ctx *const ctx,
+                                const enum libsame_gen_engine engine) {
+  assert(ctx != NULL);
+  assert(engine < LIBSAME_GEN_ENGINE_NUM);
+
+  if (engine == LIBSAME_GEN_ENGINE_ROTATOR) {
+    rot_tables_calc(ctx);
+  }
+  ctx->gen_engine = engine;
+}
+
+void libsame_afsk_templates_init(
+    struct libsame_afsk_templates *const restrict templates,
+    struct libsame_gen_ctx *const restrict ctx) {
+  assert(templates != NULL);
+  assert(ctx != NULL);
+  assert(ctx->gen_engine < LIBSAME_GEN_ENGINE_NUM);
+  assert(ctx->afsk_samples_per_bit <= LIBSAME_AFSK_SAMPLES_PER_BIT_MAX);
+
+  const struct gen_engine *const engine = &gen_engines[ctx->gen_engine];
+
+  templates->sample_rate = ctx->sample_rate;
+  templates->gen_engine = ctx->gen_engine;
+  templates->phases_num =
+      (engine->phase_set != NULL) ? LIBSAME_AFSK_TEMPLATE_PHASES_NUM : 1;
+
+  for (uint bit = 0; bit < 2; ++bit) {
+    const enum gen_tone tone = bit ? GEN_TONE_AFSK_MARK : GEN_TONE_AFSK_SPACE;
+
+    for (uint phase_index = 0; phase_index < templates->phases_num;
+         ++phase_index) {
+      union libsame_osc osc;
+      memset(&osc, 0, sizeof(osc));
+
+      if (engine->phase_set != NULL) {
+        engine->phase_set(&osc,
+                          (u32)(((u64)phase_index << 32) /
+                                LIBSAME_AFSK_TEMPLATE_PHASES_NUM));
       }
+      tone_gen(ctx, &osc, 0, tone, templates->samples[bit][phase_index],
+               ctx->afsk_samples_per_bit);
     }
   }
 }
 
-/// Retrieves the generation engine this version of libsame was compiled for.
+void libsame_ctx_afsk_templates_set(
+    struct libsame_gen_ctx *const restrict ctx,
+    const struct libsame_afsk_templates *const restrict templates) {
+  assert(ctx != NULL);
+  ctx->afsk_templates = templates;
+}
+
+void libsame_attn_sig_tile_init(
+    struct libsame_attn_sig_tile *const restrict tile,
+    struct libsame_gen_ctx *const restrict ctx) {
+  assert(tile != NULL);
+  assert(ctx != NULL);
+  assert(ctx->gen_engine < LIBSAME_GEN_ENGINE_NUM);
+  assert(ctx->sample_rate <= LIBSAME_SAMPLE_RATE_MAX);
+
+  tile->sample_rate = ctx->sample_rate;
+  tile->gen_engine = ctx->gen_engine;
+  tile->samples_num = attn_sig_period_calc(ctx->sample_rate);
+
+  union libsame_osc first;
+  union libsame_osc second;
+
+  memset(&first, 0, sizeof(first));
+  memset(&second, 0, sizeof(second));
+
+  attn_sig_synth(ctx, &first, &second, 0, tile->samples, tile->samples_num);
+}
+
+void libsame_ctx_attn_sig_tile_set(
+    struct libsame_gen_ctx *const restrict ctx,
+    const struct libsame_attn_sig_tile *const restrict tile) {
+  assert(ctx != NULL);
+  ctx->attn_sig_tile = tile;
+}
+
+void libsame_ctx_header_burst_buf_set(struct libsame_gen_ctx *const ctx,
+                                      s16 *const buf, const size_t num) {
+  assert(ctx != NULL);
+
+  ctx->header_burst_buf = buf;
+  ctx->header_burst_buf_num = (buf != NULL) ? num : 0;
+  ctx->header_burst_captured = 0;
+}
+
+/// Retrieves the generation engine contexts use by default.
 ///
-/// @returns The generation engine this version of libsame was compiled for.
+/// @returns The generation engine contexts use by default.
 enum libsame_gen_engine libsame_gen_engine_get(void) {
-#if defined(LIBSAME_CONFIG_SINE_USE_LIBC)
-  return LIBSAME_GEN_ENGINE_LIBC;
-#elif defined(LIBSAME_CONFIG_SINE_USE_LUT)
-  return LIBSAME_GEN_ENGINE_LUT;
-#elif defined(LIBSAME_CONFIG_SINE_USE_TAYLOR)
-  return LIBSAME_GEN_ENGINE_TAYLOR;
-#elif defined(LIBSAME_CONFIG_SINE_USE_APP)
-  return LIBSAME_GEN_ENGINE_APP;
-#else
-#error "Unknown generation engine!"
-#endif
+  return GEN_ENGINE_DEFAULT;
 }
 
 const char *libsame_gen_engine_desc_get(void) {
-#if defined(LIBSAME_CONFIG_SINE_USE_LIBC)
-  return "libc sinf()";
-#elif defined(LIBSAME_CONFIG_SINE_USE_LUT)
-  return "Sine wave lookup table using linear interpolation and phase "
-         "accumulators";
-#elif defined(LIBSAME_CONFIG_SINE_USE_TAYLOR)
-  return "Three-order Taylor Series";
-#elif defined(LIBSAME_CONFIG_SINE_USE_APP)
-  return "Application specified generator";
-#else
-#error "Unknown generation engine!"
-#endif
+  return libsame_gen_engine_desc_lookup(GEN_ENGINE_DEFAULT);
+}
+
+const char *libsame_gen_engine_desc_lookup(
+    const enum libsame_gen_engine engine) {
+  assert(engine < LIBSAME_GEN_ENGINE_NUM);
+  return gen_engines[engine].desc;
 }
 
 void libsame_attn_sig_durations_get(uint *const restrict min,
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file parallel.c
+/// Defines the implementation of parallel rendering.
+///
+/// A message is split into ranges of whole segments, one per thread, and each
+/// thread renders its range with its own copy of the generation context. Every
+/// segment starts with its oscillators and AFSK state cleared, which is exactly
+/// the state libsame_seek() sets up at a segment boundary, so every range comes
+/// out as it would have had the message been rendered in order.
+
+#include <assert.h>
+#include <string.h>
+
+#include "libsame/libsame.h"
+
+#ifndef __STDC_NO_THREADS__
+#include <threads.h>
+#endif  // __STDC_NO_THREADS__
+
+/// Defines the range of a message one thread renders.
+struct worker {
+  /// The generation context of the thread, at the start of the range.
+  struct libsame_gen_ctx ctx;
+
+  /// Where to store the rendered samples.
+  s16 *dst;
+
+  /// The number of samples in the range.
+  size_t num;
+
+  /// The number of samples rendered.
+  size_t generated;
+
+#ifndef __STDC_NO_THREADS__
+  /// The thread rendering the range.
+  thrd_t thread;
+
+  /// Whether the thread was started.
+  bool started;
+
+  /// Pads the flag up to the alignment of the range.
+  u8 started_padding[sizeof(size_t) - sizeof(bool)];
+#endif  // __STDC_NO_THREADS__
+};
+
+/// Determines whether a sequence state generates silence.
+///
+/// Silence costs next to nothing to render, so it does not count towards the
+/// work a thread is assigned.
+static bool state_is_silence(const enum libsame_seq_state state) {
+  switch (state) {
+    case LIBSAME_SEQ_STATE_SILENCE_FIRST:
+    case LIBSAME_SEQ_STATE_SILENCE_SECOND:
+    case LIBSAME_SEQ_STATE_SILENCE_THIRD:
+    case LIBSAME_SEQ_STATE_SILENCE_FOURTH:
+    case LIBSAME_SEQ_STATE_SILENCE_FIFTH:
+    case LIBSAME_SEQ_STATE_SILENCE_SIXTH:
+    case LIBSAME_SEQ_STATE_SILENCE_SEVENTH:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/// Renders the range of a message assigned to a thread.
+static int worker_run(void *const arg) {
+  struct worker *const worker = arg;
+
+  worker->generated =
+      libsame_samples_gen_buf(&worker->ctx, worker->dst, worker->num);
+  return 0;
+}
+
+size_t libsame_samples_gen_parallel(
+    const struct libsame_gen_ctx *const restrict ctx, s16 *const restrict dst,
+    const size_t num, uint threads_num) {
+  assert(ctx != NULL);
+  assert((dst != NULL) || (num == 0));
+  assert(threads_num > 0);
+  assert(ctx->seq_state == LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST);
+  assert(ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST] ==
+         ctx->seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND]);
+
+  if (threads_num > LIBSAME_PARALLEL_THREADS_MAX) {
+    threads_num = LIBSAME_PARALLEL_THREADS_MAX;
+  }
+
+  size_t work_total = 0;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    if (!state_is_silence((enum libsame_seq_state)state)) {
+      work_total += ctx->seq_samples_remaining[state];
+    }
+  }
+
+  // Close a range at the first segment boundary past its share of the work,
+  // such that each range renders about as much as every other.
+  struct worker workers[LIBSAME_PARALLEL_THREADS_MAX];
+  size_t workers_num = 0;
+  size_t start = 0;
+  size_t end = 0;
+  size_t work = 0;
+
+  for (size_t state = 0; (state < LIBSAME_SEQ_STATE_NUM) && (end < num);
+       ++state) {
+    end += ctx->seq_samples_remaining[state];
+
+    if (!state_is_silence((enum libsame_seq_state)state)) {
+      work += ctx->seq_samples_remaining[state];
+    }
+
+    const bool last = (state == (LIBSAME_SEQ_STATE_NUM - 1)) || (end >= num);
+    const bool share_done =
+        (work * threads_num) >= (work_total * (workers_num + 1));
+
+    if (!last && (!share_done || (workers_num == (threads_num - 1)))) {
+      continue;
+    }
+
+    struct worker *const worker = &workers[workers_num++];
+
+    worker->ctx = *ctx;
+    worker->dst = &dst[start];
+    worker->num = ((end < num) ? end : num) - start;
+    worker->generated = 0;
+
+    if (start != 0) {
+      libsame_seek(&worker->ctx, start);
+    }
+    start = end;
+  }
+
+#ifndef __STDC_NO_THREADS__
+  for (size_t i = 1; i < workers_num; ++i) {
+    workers[i].started = (thrd_create(&workers[i].thread, worker_run,
+                                      &workers[i]) == thrd_success);
+  }
+#endif  // __STDC_NO_THREADS__
+
+  // The calling thread renders the first range itself, and any range no
+  // thread could be started for.
+  size_t generated = 0;
+
+  for (size_t i = 0; i < workers_num; ++i) {
+#ifndef __STDC_NO_THREADS__
+    if ((i != 0) && workers[i].started) {
+      continue;
+    }
+#endif  // __STDC_NO_THREADS__
+
+    worker_run(&workers[i]);
+  }
+
+  for (size_t i = 0; i < workers_num; ++i) {
+#ifndef __STDC_NO_THREADS__
+    if ((i != 0) && workers[i].started) {
+      thrd_join(workers[i].thread, NULL);
+    }
+#endif  // __STDC_NO_THREADS__
+
+    generated += workers[i].generated;
+  }
+  return generated;
+}
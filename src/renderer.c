@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file renderer.c
+/// Defines the implementation of renderers.
+///
+/// A renderer is a stream whose producer side belongs to a worker thread
+/// while it is running, and to the control thread while it is not. The worker
+/// thread polls the fill level of the ring buffer rather than waiting to be
+/// woken, so the audio thread never has to signal it; the poll interval is
+/// half the time the low water mark lasts at the sample rate in use, such that
+/// a refill is never late by more than that.
+
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "libsame/libsame.h"
+
+#ifndef __STDC_NO_THREADS__
+#include <threads.h>
+
+_Static_assert(sizeof(thrd_t) <= LIBSAME_RENDERER_THREAD_SIZE,
+               "LIBSAME_RENDERER_THREAD_SIZE must hold a thread handle.");
+#endif  // __STDC_NO_THREADS__
+
+/// The number of nanoseconds in one second.
+#define NS_PER_SEC (UINT64_C(1000000000))
+
+/// Refills the ring buffer of a renderer if it needs refilling.
+///
+/// This must only be called from the producer side of the renderer.
+static size_t renderer_produce(struct libsame_renderer *const renderer) {
+  const size_t num = libsame_stream_produce(&renderer->stream);
+
+  if (num != 0) {
+    STORE_RELEASE(&renderer->refills, renderer->refills + 1);
+  }
+  return num;
+}
+
+/// Ends the message of a renderer where it is.
+///
+/// This must only be called from the producer side of the renderer.
+static void renderer_finish(struct libsame_renderer *const renderer) {
+  renderer->stream.ctx->seq_state = LIBSAME_SEQ_STATE_NUM;
+  STORE_RELEASE(&renderer->stream.finished, 1U);
+}
+
+#ifndef __STDC_NO_THREADS__
+/// The entry point of the worker thread of a renderer.
+static int renderer_worker(void *const arg) {
+  struct libsame_renderer *const renderer = arg;
+
+  const struct timespec poll = {
+      .tv_sec = (time_t)(renderer->poll_ns / NS_PER_SEC),
+      .tv_nsec = (long)(renderer->poll_ns % NS_PER_SEC)};
+
+  while (!LOAD_ACQUIRE(&renderer->stop_requested)) {
+    if (LOAD_ACQUIRE(&renderer->flushed)) {
+      renderer_finish(renderer);
+      break;
+    }
+
+    if (renderer_produce(renderer) != 0) {
+      continue;
+    }
+
+    if (renderer->stream.finished) {
+      break;
+    }
+    thrd_sleep(&poll, NULL);
+  }
+  return 0;
+}
+#endif  // __STDC_NO_THREADS__
+
+void libsame_renderer_init(struct libsame_renderer *const restrict renderer,
+                           struct libsame_gen_ctx *const restrict ctx,
+                           s16 *const restrict buf, const size_t buf_num,
+                           const size_t low_water, const size_t high_water) {
+  assert(renderer != NULL);
+  assert(ctx != NULL);
+  assert(ctx->sample_rate != 0);
+
+  memset(renderer, 0, sizeof(*renderer));
+  libsame_stream_init(&renderer->stream, ctx, buf, buf_num, low_water,
+                      high_water);
+
+  renderer->poll_ns = ((u64)low_water * NS_PER_SEC) / (2 * ctx->sample_rate);
+}
+
+bool libsame_renderer_start(struct libsame_renderer *const renderer) {
+  assert(renderer != NULL);
+  assert(!renderer->running);
+
+#ifdef __STDC_NO_THREADS__
+  return false;
+#else
+  renderer_produce(renderer);
+  STORE_RELEASE(&renderer->stop_requested, 0U);
+
+  thrd_t thread;
+
+  if (thrd_create(&thread, renderer_worker, renderer) != thrd_success) {
+    return false;
+  }
+
+  memcpy(renderer->thread.bytes, &thread, sizeof(thread));
+  renderer->running = 1;
+
+  return true;
+#endif  // __STDC_NO_THREADS__
+}
+
+void libsame_renderer_stop(struct libsame_renderer *const renderer) {
+  assert(renderer != NULL);
+
+  if (!renderer->running) {
+    return;
+  }
+
+#ifndef __STDC_NO_THREADS__
+  STORE_RELEASE(&renderer->stop_requested, 1U);
+
+  thrd_t thread;
+
+  memcpy(&thread, renderer->thread.bytes, sizeof(thread));
+  thrd_join(thread, NULL);
+#endif  // __STDC_NO_THREADS__
+
+  renderer->running = 0;
+}
+
+void libsame_renderer_flush(struct libsame_renderer *const renderer) {
+  assert(renderer != NULL);
+
+  STORE_RELEASE(&renderer->flushed, 1U);
+
+  // A running worker thread finishes the message itself once it sees the
+  // flag; otherwise, the control thread is the producer side.
+  if (!renderer->running) {
+    renderer_finish(renderer);
+  }
+}
+
+size_t libsame_renderer_read(struct libsame_renderer *const restrict renderer,
+                             s16 *const restrict dst, const size_t num) {
+  assert(renderer != NULL);
+  assert((dst != NULL) || (num == 0));
+
+  if (!LOAD_ACQUIRE(&renderer->flushed)) {
+    return libsame_stream_read(&renderer->stream, dst, num);
+  }
+
+  // Whatever the worker thread rendered before it saw the flag is dropped.
+  STORE_RELEASE(&renderer->stream.read_pos,
+                LOAD_ACQUIRE(&renderer->stream.write_pos));
+
+  if (num != 0) {
+    memset(dst, 0, num * sizeof(s16));
+  }
+  return 0;
+}
+
+bool libsame_renderer_done(const struct libsame_renderer *const renderer) {
+  assert(renderer != NULL);
+
+  return libsame_stream_done(&renderer->stream);
+}
+
+void libsame_renderer_stats_get(
+    const struct libsame_renderer *const restrict renderer,
+    struct libsame_renderer_stats *const restrict stats) {
+  assert(renderer != NULL);
+  assert(stats != NULL);
+
+  stats->played = LOAD_ACQUIRE(&renderer->stream.read_pos);
+  stats->rendered = LOAD_ACQUIRE(&renderer->stream.write_pos);
+  stats->buffered = stats->rendered - stats->played;
+  stats->refills = LOAD_ACQUIRE(&renderer->refills);
+  stats->underruns = LOAD_ACQUIRE(&renderer->stream.underruns);
+}
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file sample_fmt.c
+/// Defines the output sample format writers.
+///
+/// Multi-byte formats with a fixed byte order are stored with a plain store on
+/// hosts of that byte order, and a byte at a time otherwise, so they are
+/// correct on hosts of either byte order.
+///
+/// Every format has a contiguous writer and a strided writer for interleaved
+/// frame buffers. Layouts common enough to matter have vectorized writers of
+/// their own.
+
+#include "sample_fmt.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+
+/// Stores a 16-bit value least significant byte first.
+static inline void store_le16(u8 *const dst, const u16 value) {
+#ifdef HOST_LITTLE_ENDIAN
+  memcpy(dst, &value, sizeof(value));
+#else
+  dst[0] = (u8)value;
+  dst[1] = (u8)(value >> 8);
+#endif  // HOST_LITTLE_ENDIAN
+}
+
+/// Stores a 16-bit value most significant byte first.
+static inline void store_be16(u8 *const dst, const u16 value) {
+  store_le16(dst, (u16)((value << 8) | (value >> 8)));
+}
+
+/// Stores a 32-bit value least significant byte first.
+static inline void store_le32(u8 *const dst, const u32 value) {
+#ifdef HOST_LITTLE_ENDIAN
+  memcpy(dst, &value, sizeof(value));
+#else
+  dst[0] = (u8)value;
+  dst[1] = (u8)(value >> 8);
+  dst[2] = (u8)(value >> 16);
+  dst[3] = (u8)(value >> 24);
+#endif  // HOST_LITTLE_ENDIAN
+}
+
+/// Stores a sample as a signed 16-bit little-endian sample.
+static inline void store_s16le(u8 *const dst, const s16 sample) {
+  store_le16(dst, (u16)sample);
+}
+
+/// Stores a sample as a signed 16-bit big-endian sample.
+static inline void store_s16be(u8 *const dst, const s16 sample) {
+  store_be16(dst, (u16)sample);
+}
+
+/// Stores a sample as a packed signed 24-bit little-endian sample.
+static inline void store_s24le(u8 *const dst, const s16 sample) {
+  dst[0] = 0;
+  store_le16(&dst[1], (u16)sample);
+}
+
+/// Stores a sample as a signed 32-bit little-endian sample.
+static inline void store_s32le(u8 *const dst, const s16 sample) {
+  store_le32(dst, (u32)(u16)sample << 16);
+}
+
+/// Stores a sample as a native-endian 32-bit floating point sample in the
+/// range [-1, 1).
+static inline void store_f32(u8 *const dst, const s16 sample) {
+  const float value = (float)sample * (1.0F / 32768.0F);
+  memcpy(dst, &value, sizeof(value));
+}
+
+/// Defines the writers of an output sample format from the function storing
+/// one sample of it. The contiguous writer is a plain loop compilers
+/// vectorize; the strided writer converts each sample once and stores it to
+/// every channel of its frame.
+#define SAMPLE_FMT_WRITERS_DEFINE(name, size)                                  \
+  static void write_##name(const s16 *const restrict src,                      \
+                           u8 *const restrict dst, const size_t num) {         \
+    for (size_t i = 0; i < num; ++i) {                                         \
+      store_##name(&dst[i * (size)], src[i]);                                  \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static void write_strided_##name(                                            \
+      const s16 *const restrict src, u8 *const restrict dst, const size_t num, \
+      const size_t stride, const size_t channels) {                            \
+    for (size_t i = 0; i < num; ++i) {                                         \
+      u8 *const frame = &dst[i * stride * (size)];                             \
+                                                                               \
+      for (size_t channel = 0; channel < channels; ++channel) {                \
+        store_##name(&frame[channel * (size)], src[i]);                        \
+      }                                                                        \
+    }                                                                          \
+  }
+
+SAMPLE_FMT_WRITERS_DEFINE(s16le, 2)
+SAMPLE_FMT_WRITERS_DEFINE(s16be, 2)
+SAMPLE_FMT_WRITERS_DEFINE(s24le, 3)
+SAMPLE_FMT_WRITERS_DEFINE(s32le, 4)
+SAMPLE_FMT_WRITERS_DEFINE(f32, sizeof(float))
+
+#if defined(__SSE2__) && defined(HOST_LITTLE_ENDIAN)
+/// Writes signed 16-bit little-endian samples to both channels of stereo
+/// frames, eight frames at a time using SSE2.
+static void write_s16le_stereo_sse2(const s16 *const restrict src,
+                                    u8 *const restrict dst, const size_t num) {
+  size_t i = 0;
+
+  for (; i + 8 <= num; i += 8) {
+    const __m128i samples = _mm_loadu_si128((const __m128i *)&src[i]);
+
+    _mm_storeu_si128((__m128i *)&dst[i * 4],
+                     _mm_unpacklo_epi16(samples, samples));
+    _mm_storeu_si128((__m128i *)&dst[(i * 4) + 16],
+                     _mm_unpackhi_epi16(samples, samples));
+  }
+  write_strided_s16le(&src[i], &dst[i * 4], num - i, 2, 2);
+}
+#endif  // defined(__SSE2__) && defined(HOST_LITTLE_ENDIAN)
+
+const struct sample_fmt sample_fmts[LIBSAME_SAMPLE_FMT_NUM] = {
+    [LIBSAME_SAMPLE_FMT_S16LE] = {.size = 2,
+                                  .write = write_s16le,
+                                  .write_strided = write_strided_s16le},
+    [LIBSAME_SAMPLE_FMT_S16BE] = {.size = 2,
+                                  .write = write_s16be,
+                                  .write_strided = write_strided_s16be},
+    [LIBSAME_SAMPLE_FMT_S24LE] = {.size = 3,
+                                  .write = write_s24le,
+                                  .write_strided = write_strided_s24le},
+    [LIBSAME_SAMPLE_FMT_S32LE] = {.size = 4,
+                                  .write = write_s32le,
+                                  .write_strided = write_strided_s32le},
+    [LIBSAME_SAMPLE_FMT_F32] = {.size = sizeof(float),
+                                .write = write_f32,
+                                .write_strided = write_strided_f32}};
+
+void sample_fmt_write(const enum libsame_sample_fmt fmt,
+                      const s16 *const restrict src, u8 *const restrict dst,
+                      const size_t num, const size_t stride,
+                      const size_t channels) {
+  assert(fmt < LIBSAME_SAMPLE_FMT_NUM);
+  assert(channels > 0);
+  assert(channels <= stride);
+
+  const struct sample_fmt *const sample_fmt = &sample_fmts[fmt];
+
+  if (stride == 1) {
+    sample_fmt->write(src, dst, num);
+    return;
+  }
+
+#if defined(__SSE2__) && defined(HOST_LITTLE_ENDIAN)
+  if ((fmt == LIBSAME_SAMPLE_FMT_S16LE) && (stride == 2) && (channels == 2)) {
+    write_s16le_stereo_sse2(src, dst, num);
+    return;
+  }
+#endif  // defined(__SSE2__) && defined(HOST_LITTLE_ENDIAN)
+
+  sample_fmt->write_strided(src, dst, num, stride, channels);
+}
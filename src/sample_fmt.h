@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file sample_fmt.h
+/// Defines the interface of the output sample format writers.
+///
+/// Generation engines only ever produce signed 16-bit samples. Output in any
+/// other sample format is generated a small block at a time, and each block is
+/// converted by the writer for the requested format while it is still in the
+/// L1 cache. Every writer is a specialized loop over a whole block; none of
+/// them branch on the format per sample.
+
+#ifndef LIBSAME_PRIVATE_SAMPLE_FMT_H
+#define LIBSAME_PRIVATE_SAMPLE_FMT_H
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#include "libsame/libsame.h"
+
+/// Defines an output sample format.
+struct sample_fmt {
+  /// The number of bytes one sample occupies.
+  size_t size;
+
+  /// Converts a span of samples to the output sample format.
+  ///
+  /// @param src The samples to convert.
+  /// @param dst Where to store the converted samples.
+  /// @param num The number of samples to convert.
+  void (*write)(const s16 *const restrict src, u8 *const restrict dst,
+                const size_t num);
+
+  /// Converts a span of samples to the output sample format, storing each to
+  /// one or more consecutive channels of an interleaved frame buffer.
+  ///
+  /// @param src The samples to convert.
+  /// @param dst Where to store the first channel of the first frame.
+  /// @param num The number of samples, and therefore frames, to convert.
+  /// @param stride The number of samples in one frame.
+  /// @param channels The number of consecutive channels to store each sample
+  ///                 to.
+  void (*write_strided)(const s16 *const restrict src, u8 *const restrict dst,
+                        const size_t num, const size_t stride,
+                        const size_t channels);
+};
+
+/// The output sample formats, indexed by enum libsame_sample_fmt.
+extern const struct sample_fmt sample_fmts[LIBSAME_SAMPLE_FMT_NUM];
+
+/// Converts a span of samples to an output sample format, using the fastest
+/// writer for the layout.
+///
+/// @param fmt The output sample format.
+/// @param src The samples to convert.
+/// @param dst Where to store the first channel of the first frame.
+/// @param num The number of samples, and therefore frames, to convert.
+/// @param stride The number of samples in one frame; 1 for a contiguous buffer.
+/// @param channels The number of consecutive channels to store each sample to.
+///                 This must not exceed stride.
+void sample_fmt_write(const enum libsame_sample_fmt fmt,
+                      const s16 *const restrict src, u8 *const restrict dst,
+                      const size_t num, const size_t stride,
+                      const size_t channels);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // LIBSAME_PRIVATE_SAMPLE_FMT_H
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file stream.c
+/// Defines the implementation of streams.
+///
+/// The ring buffer holds at most buf_num samples; the number of samples in it
+/// is the write position minus the read position, which stays correct across
+/// wraparound of either. The producer publishes samples by storing the write
+/// position with release semantics once they are written, and the consumer
+/// frees them by storing the read position with release semantics once they
+/// are copied out, so neither side ever touches samples the other owns.
+
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "libsame/libsame.h"
+
+#ifndef LOAD_ACQUIRE
+#error "Streams require the __atomic builtins of GCC or Clang."
+#endif  // LOAD_ACQUIRE
+
+void libsame_stream_init(struct libsame_stream *const restrict stream,
+                         struct libsame_gen_ctx *const restrict ctx,
+                         s16 *const restrict buf, const size_t buf_num,
+                         const size_t low_water, const size_t high_water) {
+  assert(stream != NULL);
+  assert(ctx != NULL);
+  assert(buf != NULL);
+  assert((buf_num != 0) && ((buf_num & (buf_num - 1)) == 0));
+  assert(low_water > 0);
+  assert(low_water <= high_water);
+  assert(high_water <= buf_num);
+
+  memset(stream, 0, sizeof(*stream));
+
+  stream->ctx = ctx;
+  stream->buf = buf;
+  stream->mask = buf_num - 1;
+  stream->low_water = low_water;
+  stream->high_water = high_water;
+}
+
+size_t libsame_stream_produce(struct libsame_stream *const stream) {
+  assert(stream != NULL);
+
+  if (stream->finished) {
+    return 0;
+  }
+
+  const size_t write_pos = stream->write_pos;
+  const size_t buffered = write_pos - LOAD_ACQUIRE(&stream->read_pos);
+
+  if (buffered >= stream->low_water) {
+    return 0;
+  }
+
+  // The span to fill can wrap around the end of the ring buffer, so it is
+  // generated in at most two pieces.
+  const size_t want = stream->high_water - buffered;
+  const size_t index = write_pos & stream->mask;
+  const size_t first = (stream->mask + 1) - index;
+  const size_t first_num = (want < first) ? want : first;
+
+  size_t num =
+      libsame_samples_gen_buf(stream->ctx, &stream->buf[index], first_num);
+
+  if ((num == first_num) && (want > first_num)) {
+    num += libsame_samples_gen_buf(stream->ctx, stream->buf, want - first_num);
+  }
+
+  STORE_RELEASE(&stream->write_pos, write_pos + num);
+
+  if (num < want) {
+    STORE_RELEASE(&stream->finished, 1U);
+  }
+  return num;
+}
+
+size_t libsame_stream_read(struct libsame_stream *const restrict stream,
+                           s16 *const restrict dst, const size_t num) {
+  assert(stream != NULL);
+  assert((dst != NULL) || (num == 0));
+
+  if (num == 0) {
+    return 0;
+  }
+
+  const size_t read_pos = stream->read_pos;
+  const size_t buffered = LOAD_ACQUIRE(&stream->write_pos) - read_pos;
+  const size_t read_num = (buffered < num) ? buffered : num;
+
+  const size_t index = read_pos & stream->mask;
+  const size_t first = (stream->mask + 1) - index;
+  const size_t first_num = (read_num < first) ? read_num : first;
+
+  memcpy(dst, &stream->buf[index], first_num * sizeof(s16));
+  memcpy(&dst[first_num], stream->buf, (read_num - first_num) * sizeof(s16));
+
+  STORE_RELEASE(&stream->read_pos, read_pos + read_num);
+
+  if (read_num < num) {
+    memset(&dst[read_num], 0, (num - read_num) * sizeof(s16));
+
+    // Running out at the end of the sequence is not an underrun.
+    if (!LOAD_ACQUIRE(&stream->finished)) {
+      STORE_RELEASE(&stream->underruns, stream->underruns + 1);
+    }
+  }
+  return read_num;
+}
+
+size_t libsame_stream_buffered(const struct libsame_stream *const stream) {
+  assert(stream != NULL);
+
+  // Loading the read position first means the write position loaded after it
+  // can only be further along, so the difference never wraps.
+  const size_t read_pos = LOAD_ACQUIRE(&stream->read_pos);
+  return LOAD_ACQUIRE(&stream->write_pos) - read_pos;
+}
+
+bool libsame_stream_done(const struct libsame_stream *const stream) {
+  assert(stream != NULL);
+
+  // The write position is final once the producer has finished, and the
+  // acquire load of the flag makes sure it is the final one that is loaded.
+  if (!LOAD_ACQUIRE(&stream->finished)) {
+    return false;
+  }
+  return LOAD_ACQUIRE(&stream->read_pos) == LOAD_ACQUIRE(&stream->write_pos);
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2023-2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file wav.c
+/// Defines the implementation of WAV file rendering.
+///
+/// A WAV file is a fixed size header followed by the samples as is, and the
+/// length of every segment of a message is known as soon as the generation
+/// context is initialized. The whole file can therefore be laid out before a
+/// single sample is generated, and the samples generated straight into their
+/// place in it, typically a memory-mapped file.
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "libsame/libsame.h"
+
+/// The number of bytes one sample occupies in a WAV file.
+#define WAV_SAMPLE_SIZE (2)
+
+/// Stores a 16-bit value in little-endian byte order.
+static void le16_store(u8 *const dst, const u16 value) {
+  dst[0] = (u8)value;
+  dst[1] = (u8)(value >> 8);
+}
+
+/// Stores a 32-bit value in little-endian byte order.
+static void le32_store(u8 *const dst, const u32 value) {
+  le16_store(&dst[0], (u16)value);
+  le16_store(&dst[2], (u16)(value >> 16));
+}
+
+/// Calculates the number of samples remaining in the message of a generation
+/// context.
+static size_t samples_remaining_get(const struct libsame_gen_ctx *const ctx) {
+  size_t num = 0;
+
+  for (size_t state = ctx->seq_state; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    num += ctx->seq_samples_remaining[state];
+  }
+  return num;
+}
+
+void libsame_wav_header_store(void *const dst, const unsigned int sample_rate,
+                              const size_t samples_num) {
+  assert(dst != NULL);
+
+  const size_t data_size = samples_num * WAV_SAMPLE_SIZE;
+
+  // The sizes in the header are 32 bits wide, which no message comes near.
+  assert(data_size <= (UINT32_MAX - LIBSAME_WAV_HEADER_SIZE));
+
+  u8 *const header = dst;
+
+  memcpy(&header[0], "RIFF", 4);
+  le32_store(&header[4], (u32)(data_size + LIBSAME_WAV_HEADER_SIZE - 8));
+  memcpy(&header[8], "WAVEfmt ", 8);
+  le32_store(&header[16], 16);                             // fmt size
+  le16_store(&header[20], 1);                              // PCM
+  le16_store(&header[22], 1);                              // Mono
+  le32_store(&header[24], sample_rate);                    // Sample rate
+  le32_store(&header[28], sample_rate * WAV_SAMPLE_SIZE);  // Byte rate
+  le16_store(&header[32], WAV_SAMPLE_SIZE);                // Block align
+  le16_store(&header[34], 16);                             // Bits/sample
+  memcpy(&header[36], "data", 4);
+  le32_store(&header[40], (u32)data_size);
+}
+
+size_t libsame_wav_size_get(const struct libsame_gen_ctx *const ctx) {
+  assert(ctx != NULL);
+  assert(ctx->seq_state <= LIBSAME_SEQ_STATE_NUM);
+
+  return LIBSAME_WAV_HEADER_SIZE +
+         (samples_remaining_get(ctx) * WAV_SAMPLE_SIZE);
+}
+
+size_t libsame_wav_render(struct libsame_gen_ctx *const restrict ctx,
+                          void *const restrict dst, const size_t size) {
+  assert(ctx != NULL);
+  assert(dst != NULL);
+  assert(ctx->seq_state <= LIBSAME_SEQ_STATE_NUM);
+
+  const size_t samples_num = samples_remaining_get(ctx);
+
+  assert(size >= (LIBSAME_WAV_HEADER_SIZE + (samples_num * WAV_SAMPLE_SIZE)));
+  (void)size;
+
+  libsame_wav_header_store(dst, ctx->sample_rate, samples_num);
+
+  u8 *const data = (u8 *)dst + LIBSAME_WAV_HEADER_SIZE;
+
+#ifdef HOST_LITTLE_ENDIAN
+  // Native samples are already in the byte order of the file, so when they
+  // can be stored in place, the generation engine writes them there directly.
+  if (((uintptr_t)data % _Alignof(s16)) == 0) {
+    return libsame_samples_gen_buf(ctx, (s16 *)(void *)data, samples_num);
+  }
+#endif  // HOST_LITTLE_ENDIAN
+
+  return libsame_samples_gen_fmt(ctx, LIBSAME_SAMPLE_FMT_S16LE, data,
+                                 samples_num);
+}
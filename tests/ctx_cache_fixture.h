@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file ctx_cache_fixture.h
+/// Defines the pair of generation contexts shared by the tests of the caches a
+/// generation context can copy samples from: one synthesizes every sample, and
+/// the other has a cache attached.
+
+#ifndef LIBSAME_TESTS_CTX_CACHE_FIXTURE_H
+#define LIBSAME_TESTS_CTX_CACHE_FIXTURE_H
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 44100;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_gen_ctx synth_ctx = {};
+s16 synth_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+struct libsame_gen_ctx cached_ctx = {};
+s16 cached_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+
+/// Prepares a generation context to generate the message from the specified
+/// state.
+void ctx_prepare(struct libsame_gen_ctx *const ctx,
+                 const enum libsame_gen_engine engine,
+                 const unsigned int sample_rate,
+                 const enum libsame_seq_state seq_state =
+                     LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST) {
+  std::memset(ctx, 0, sizeof(*ctx));
+
+  libsame_ctx_init(ctx, &header, sample_rate);
+  libsame_ctx_gen_engine_set(ctx, engine);
+
+  if (seq_state != LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST) {
+    struct libsame_segment_map map;
+
+    libsame_segment_map_get(&map, &header, sample_rate);
+    libsame_seek(ctx, map.segments[seq_state].start);
+  }
+}
+
+/// Prepares both generation contexts to generate the message at SAMPLE_RATE
+/// from the specified state, with no cache attached to either.
+void ctxs_prepare(const enum libsame_gen_engine engine,
+                  const enum libsame_seq_state seq_state =
+                      LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST) {
+  libsame_init();
+
+  ctx_prepare(&synth_ctx, engine, SAMPLE_RATE, seq_state);
+  ctx_prepare(&cached_ctx, engine, SAMPLE_RATE, seq_state);
+}
+
+/// Generates both generation contexts to completion, checking every sample is
+/// within the specified error of the other.
+void ctxs_compare(const int max_error = 0) {
+  while (synth_ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+    libsame_samples_gen(&synth_ctx, synth_samples);
+    libsame_samples_gen(&cached_ctx, cached_samples);
+
+    for (size_t i = 0; i < LIBSAME_SAMPLES_NUM_MAX; ++i) {
+      ASSERT_NEAR(cached_samples[i], synth_samples[i], max_error) << i;
+    }
+  }
+}
+};  // namespace
+
+#endif  // LIBSAME_TESTS_CTX_CACHE_FIXTURE_H
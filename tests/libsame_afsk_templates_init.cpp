@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 44100;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_afsk_templates templates = {};
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the templates record what they were rendered for.
+TEST(libsame_afsk_templates_init, RecordsSampleRateAndEngine) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_SIMD);
+  libsame_afsk_templates_init(&templates, &ctx);
+
+  EXPECT_EQ(templates.sample_rate, SAMPLE_RATE);
+  EXPECT_EQ(templates.gen_engine, LIBSAME_GEN_ENGINE_SIMD);
+}
+
+/// Verifies that a generation engine which restarts its phase on every bit
+/// only has one template rendered per bit value.
+TEST(libsame_afsk_templates_init, PhaseRestartingEngineRendersOnePhase) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_LIBC);
+  libsame_afsk_templates_init(&templates, &ctx);
+
+  EXPECT_EQ(templates.phases_num, 1);
+}
+
+/// Verifies that a generation engine which keeps its phase across bits has a
+/// template rendered for every start phase, each starting at its phase.
+TEST(libsame_afsk_templates_init, PhaseKeepingEngineRendersEveryPhase) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_POLY);
+  libsame_afsk_templates_init(&templates, &ctx);
+
+  ASSERT_EQ(templates.phases_num, LIBSAME_AFSK_TEMPLATE_PHASES_NUM);
+
+  // A quarter of a turn in starts at the peak of the sine wave.
+  const unsigned int quarter = LIBSAME_AFSK_TEMPLATE_PHASES_NUM / 4;
+
+  for (unsigned int bit = 0; bit < 2; ++bit) {
+    EXPECT_EQ(templates.samples[bit][0][0], 0);
+    EXPECT_NEAR(templates.samples[bit][quarter][0], INT16_MAX, 1);
+  }
+}
+
+/// Verifies that rendering templates does not modify the generation context.
+TEST(libsame_afsk_templates_init, CtxIsNotModified) {
+  static struct libsame_gen_ctx ctx = {};
+  static struct libsame_gen_ctx orig = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_ROTATOR);
+
+  std::memcpy(&orig, &ctx, sizeof(ctx));
+  libsame_afsk_templates_init(&templates, &ctx);
+
+  EXPECT_EQ(std::memcmp(&orig, &ctx, sizeof(ctx)), 0);
+}
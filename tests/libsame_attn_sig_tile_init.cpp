@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_attn_sig_tile tile = {};
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the tile records what it was rendered for.
+TEST(libsame_attn_sig_tile_init, RecordsSampleRateAndEngine) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_DDS);
+  libsame_attn_sig_tile_init(&tile, &ctx);
+
+  EXPECT_EQ(tile.sample_rate, 44100);
+  EXPECT_EQ(tile.gen_engine, LIBSAME_GEN_ENGINE_DDS);
+}
+
+/// Verifies that the tile spans exactly one period of the attention signal.
+TEST(libsame_attn_sig_tile_init, SpansOnePeriod) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_init();
+
+  // 853 Hz is prime and does not divide 960 Hz, so the attention signal only
+  // repeats after a whole second, even at sample rates where one of the tones
+  // repeats sooner.
+  for (const unsigned int sample_rate : {8000U, 22050U, 44100U, 48000U,
+                                         853U * 80U, 96000U}) {
+    libsame_ctx_init(&ctx, &header, sample_rate);
+    libsame_attn_sig_tile_init(&tile, &ctx);
+
+    EXPECT_EQ(tile.samples_num, sample_rate);
+  }
+}
+
+/// Verifies that rendering the tile does not modify the generation context.
+TEST(libsame_attn_sig_tile_init, CtxIsNotModified) {
+  static struct libsame_gen_ctx ctx = {};
+  static struct libsame_gen_ctx orig = {};
+
+  libsame_init();
+  libsame_ctx_init(&ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_LUT);
+
+  std::memcpy(&orig, &ctx, sizeof(ctx));
+  libsame_attn_sig_tile_init(&tile, &ctx);
+
+  EXPECT_EQ(std::memcmp(&orig, &ctx, sizeof(ctx)), 0);
+}
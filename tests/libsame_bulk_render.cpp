@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+/// The number of headers rendered.
+constexpr size_t HEADERS_NUM = 32;
+
+/// The sample rate the messages are rendered at.
+constexpr unsigned int SAMPLE_RATE = 8000;
+
+/// The location codes the headers draw from.
+constexpr const char *LOCATION_CODES[] = {"048484", "048024", "101010",
+                                          "010101", "048453", "048029"};
+
+/// The headers, varying in location code count and attention signal
+/// duration.
+struct libsame_header headers[HEADERS_NUM];
+
+/// The samples delivered for each message.
+std::vector<s16> delivered[HEADERS_NUM];
+
+/// The number of samples reported complete for each message, and the number
+/// of times each was reported.
+size_t done_samples_num[HEADERS_NUM];
+std::atomic<unsigned int> done_counts[HEADERS_NUM];
+
+void headers_prepare() {
+  libsame_init();
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    struct libsame_header *const header = &headers[i];
+    const size_t locations_num = 1 + (i % 6);
+
+    std::memset(header, 0, sizeof(*header));
+
+    for (size_t loc = 0; loc < locations_num; ++loc) {
+      std::strcpy(header->location_codes[loc], LOCATION_CODES[(i + loc) % 6]);
+    }
+    std::strcpy(header->location_codes[locations_num],
+                LIBSAME_LOCATION_CODE_END_MARKER);
+    std::strcpy(header->valid_time_period, "0030");
+    std::strcpy(header->originator_code, "WXR");
+    std::strcpy(header->event_code, "TOR");
+    std::strcpy(header->callsign, "KEWX/NWS");
+    std::strcpy(header->originator_time, "1231200");
+    header->attn_sig_duration = 8 + static_cast<unsigned int>((i * 7) % 11);
+  }
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    delivered[i].clear();
+    done_samples_num[i] = 0;
+    done_counts[i] = 0;
+  }
+}
+
+void sink_write(void *const userdata, const size_t msg,
+                const s16 *const samples, const size_t num) {
+  EXPECT_EQ(userdata, &delivered);
+  delivered[msg].insert(delivered[msg].end(), samples, samples + num);
+}
+
+void sink_done(void *const userdata, const size_t msg,
+               const size_t samples_num) {
+  EXPECT_EQ(userdata, &delivered);
+  done_samples_num[msg] = samples_num;
+  done_counts[msg]++;
+}
+
+/// The WAV files rendered for each message.
+std::vector<u8> files[HEADERS_NUM];
+
+void *sink_wav_map(void *const userdata, const size_t msg, const size_t size) {
+  EXPECT_EQ(userdata, &delivered);
+
+  // Skip one message, to exercise a sink turning one down.
+  if (msg == 1) {
+    return nullptr;
+  }
+  files[msg].assign(size, 0xAA);
+  return files[msg].data();
+}
+
+/// The memory each message is being generated into through span_get, the
+/// bytes generated into it so far, and the number of spans provided.
+std::vector<u8> spans[HEADERS_NUM];
+std::vector<u8> span_bytes[HEADERS_NUM];
+size_t spans_num[HEADERS_NUM];
+
+void *sink_span_get(void *const userdata, const size_t msg,
+                    size_t *const size) {
+  EXPECT_EQ(userdata, &delivered);
+
+  // Stop one message after its first span, to exercise a sink turning the
+  // rest down.
+  if ((msg == 1) && (spans_num[msg] != 0)) {
+    return nullptr;
+  }
+
+  // Vary the sizes of the spans, including odd ones.
+  *size = 2 + ((spans_num[msg]++ * 37) % 1001);
+  spans[msg].assign(*size + 1, 0xAA);
+  return spans[msg].data();
+}
+
+void sink_span_put(void *const userdata, const size_t msg, const size_t size) {
+  EXPECT_EQ(userdata, &delivered);
+  ASSERT_LE(size + 1, spans[msg].size());
+
+  // Nothing past the bytes reported is touched.
+  EXPECT_EQ(spans[msg][size], 0xAA);
+  span_bytes[msg].insert(span_bytes[msg].end(), spans[msg].begin(),
+                         spans[msg].begin() + static_cast<ptrdiff_t>(size));
+}
+
+constexpr struct libsame_bulk_sink sink = {.write = sink_write,
+                                           .done = sink_done,
+                                           .wav_map = nullptr,
+                                           .span_get = nullptr,
+                                           .span_put = nullptr,
+                                           .userdata = &delivered};
+
+/// Renders a message in order on the calling thread.
+std::vector<s16> serial_render(const struct libsame_header *const header) {
+  struct libsame_gen_ctx ctx;
+  std::vector<s16> samples;
+  s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  size_t num;
+
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, header, SAMPLE_RATE);
+
+  while ((num = libsame_samples_gen_buf(&ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    samples.insert(samples.end(), buf, buf + num);
+  }
+  return samples;
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every message is delivered whole, in order and exactly once,
+/// no matter how many threads render them.
+TEST(libsame_bulk_render, DeliversEveryMessage) {
+  constexpr unsigned int THREADS_NUMS[] = {1, 2, 3, 8, 1000};
+
+  for (const auto threads_num : THREADS_NUMS) {
+    SCOPED_TRACE(threads_num);
+    headers_prepare();
+
+    const size_t total = libsame_bulk_render(headers, HEADERS_NUM, SAMPLE_RATE,
+                                             &sink, threads_num);
+    size_t expected_total = 0;
+
+    for (size_t i = 0; i < HEADERS_NUM; ++i) {
+      SCOPED_TRACE(i);
+
+      const std::vector<s16> expected = serial_render(&headers[i]);
+
+      ASSERT_EQ(done_counts[i], 1U);
+      ASSERT_EQ(done_samples_num[i], expected.size());
+      ASSERT_EQ(delivered[i], expected);
+      expected_total += expected.size();
+    }
+    EXPECT_EQ(total, expected_total);
+  }
+}
+
+/// Verifies that the completion callback is optional.
+TEST(libsame_bulk_render, NoDoneCallback) {
+  headers_prepare();
+
+  const struct libsame_bulk_sink write_only = {.write = sink_write,
+                                               .done = nullptr,
+                                               .wav_map = nullptr,
+                                               .span_get = nullptr,
+                                               .span_put = nullptr,
+                                               .userdata = &delivered};
+
+  EXPECT_NE(libsame_bulk_render(headers, 3, SAMPLE_RATE, &write_only, 2), 0);
+
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(delivered[i], serial_render(&headers[i]));
+  }
+  EXPECT_TRUE(delivered[3].empty());
+}
+
+/// Verifies that messages are rendered as whole WAV files into the memory the
+/// sink provides, and that returning no memory skips a message.
+TEST(libsame_bulk_render, WavMap) {
+  headers_prepare();
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    files[i].clear();
+  }
+
+  const struct libsame_bulk_sink wav_sink = {.write = nullptr,
+                                             .done = sink_done,
+                                             .wav_map = sink_wav_map,
+                                             .span_get = nullptr,
+                                             .span_put = nullptr,
+                                             .userdata = &delivered};
+
+  const size_t total =
+      libsame_bulk_render(headers, HEADERS_NUM, SAMPLE_RATE, &wav_sink, 3);
+  size_t expected_total = 0;
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    SCOPED_TRACE(i);
+    ASSERT_EQ(done_counts[i], 1U);
+
+    if (i == 1) {
+      EXPECT_EQ(done_samples_num[i], 0);
+      EXPECT_TRUE(files[i].empty());
+      continue;
+    }
+
+    const std::vector<s16> expected = serial_render(&headers[i]);
+
+    ASSERT_EQ(done_samples_num[i], expected.size());
+    ASSERT_EQ(files[i].size(),
+              LIBSAME_WAV_HEADER_SIZE + (expected.size() * sizeof(s16)));
+
+    for (size_t j = 0; j < expected.size(); ++j) {
+      const u8 *const sample = &files[i][LIBSAME_WAV_HEADER_SIZE + (j * 2)];
+      ASSERT_EQ(static_cast<s16>(sample[0] | (sample[1] << 8)), expected[j])
+          << j;
+    }
+    expected_total += expected.size();
+  }
+  EXPECT_EQ(total, expected_total);
+}
+
+/// Verifies that messages are generated into the spans the sink provides as
+/// little-endian samples, and that providing no span stops a message.
+TEST(libsame_bulk_render, Spans) {
+  headers_prepare();
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    span_bytes[i].clear();
+    spans_num[i] = 0;
+  }
+
+  const struct libsame_bulk_sink span_sink = {.write = nullptr,
+                                              .done = sink_done,
+                                              .wav_map = nullptr,
+                                              .span_get = sink_span_get,
+                                              .span_put = sink_span_put,
+                                              .userdata = &delivered};
+
+  const size_t total =
+      libsame_bulk_render(headers, HEADERS_NUM, SAMPLE_RATE, &span_sink, 3);
+  size_t expected_total = 0;
+
+  for (size_t i = 0; i < HEADERS_NUM; ++i) {
+    SCOPED_TRACE(i);
+    ASSERT_EQ(done_counts[i], 1U);
+
+    std::vector<s16> expected = serial_render(&headers[i]);
+
+    if (i == 1) {
+      expected.resize(1);
+    }
+
+    ASSERT_EQ(done_samples_num[i], expected.size());
+    ASSERT_EQ(span_bytes[i].size(), expected.size() * sizeof(s16));
+
+    for (size_t j = 0; j < expected.size(); ++j) {
+      const u8 *const sample = &span_bytes[i][j * 2];
+      ASSERT_EQ(static_cast<s16>(sample[0] | (sample[1] << 8)), expected[j])
+          << j;
+    }
+    expected_total += expected.size();
+  }
+  EXPECT_EQ(total, expected_total);
+}
+
+/// Verifies that rendering no headers renders nothing.
+TEST(libsame_bulk_render, Empty) {
+  EXPECT_EQ(libsame_bulk_render(nullptr, 0, SAMPLE_RATE, &sink, 4), 0);
+}
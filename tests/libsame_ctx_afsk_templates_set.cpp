@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ctx_cache_fixture.h"
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+struct libsame_afsk_templates templates = {};
+
+/// Prepares one generation context to synthesize every AFSK bit and another to
+/// copy them from templates rendered at the specified sample rate.
+void ctxs_init(const enum libsame_gen_engine engine,
+               const unsigned int templates_sample_rate) {
+  libsame_init();
+
+  ctx_prepare(&synth_ctx, engine, templates_sample_rate);
+  libsame_afsk_templates_init(&templates, &synth_ctx);
+
+  ctxs_prepare(engine);
+  libsame_ctx_afsk_templates_set(&cached_ctx, &templates);
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that generation engines which restart their phase on every bit
+/// produce exactly the same samples from templates.
+TEST(libsame_ctx_afsk_templates_set, PhaseRestartingEnginesAreExact) {
+  for (const auto engine : {LIBSAME_GEN_ENGINE_LIBC, LIBSAME_GEN_ENGINE_SIMD}) {
+    ctxs_init(engine, SAMPLE_RATE);
+    ctxs_compare(0);
+  }
+}
+
+/// Verifies that generation engines which keep their phase across bits stay
+/// within the rounding of the start phase when using templates, and that the
+/// rounding does not accumulate over a message.
+TEST(libsame_ctx_afsk_templates_set, PhaseKeepingEnginesStayInPhase) {
+  // The start phase is off by at most half of the spacing between templates,
+  // which moves a sample by at most that angle times the amplitude. The slack
+  // covers the rounding of the engines themselves, chiefly the LUT engine,
+  // whose floating point phase accumulator drifts from the exact increments
+  // the templates advance by.
+  const int max_error =
+      static_cast<int>(INT16_MAX * 3.14159265F /
+                       LIBSAME_AFSK_TEMPLATE_PHASES_NUM) +
+      32;
+
+  for (const auto engine :
+       {LIBSAME_GEN_ENGINE_LUT, LIBSAME_GEN_ENGINE_POLY, LIBSAME_GEN_ENGINE_DDS,
+        LIBSAME_GEN_ENGINE_ROTATOR, LIBSAME_GEN_ENGINE_POLY_FIXED}) {
+    ctxs_init(engine, SAMPLE_RATE);
+    ctxs_compare(max_error);
+  }
+}
+
+/// Verifies that templates rendered at another sample rate are ignored.
+TEST(libsame_ctx_afsk_templates_set, MismatchedTemplatesAreIgnored) {
+  ctxs_init(LIBSAME_GEN_ENGINE_DDS, 48000);
+  ctxs_compare(0);
+}
+
+/// Verifies that libsame_ctx_init() detaches any templates.
+TEST(libsame_ctx_afsk_templates_set, CtxInitDetachesTemplates) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_afsk_templates_set(&ctx, &templates);
+  EXPECT_EQ(ctx.afsk_templates, &templates);
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  EXPECT_EQ(ctx.afsk_templates, nullptr);
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include "ctx_cache_fixture.h"
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+struct libsame_attn_sig_tile tile = {};
+
+/// Prepares one generation context to synthesize the attention signal and
+/// another to copy it from a tile rendered at the specified sample rate. Both
+/// start at the attention signal.
+void ctxs_init(const enum libsame_gen_engine engine,
+               const unsigned int tile_sample_rate) {
+  libsame_init();
+
+  ctx_prepare(&synth_ctx, engine, tile_sample_rate);
+  libsame_attn_sig_tile_init(&tile, &synth_ctx);
+
+  ctxs_prepare(engine, LIBSAME_SEQ_STATE_ATTENTION_SIGNAL);
+  libsame_ctx_attn_sig_tile_set(&cached_ctx, &tile);
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the first period copied from the tile is exactly what the
+/// generation engine synthesizes, and that later periods repeat it.
+TEST(libsame_ctx_attn_sig_tile_set, TileRepeatsFirstPeriod) {
+  for (int engine = 0; engine < LIBSAME_GEN_ENGINE_NUM; ++engine) {
+    if (engine == LIBSAME_GEN_ENGINE_APP) {
+      continue;
+    }
+    ctxs_init(static_cast<enum libsame_gen_engine>(engine), SAMPLE_RATE);
+
+    size_t pos = 0;
+
+    while (cached_ctx.seq_state == LIBSAME_SEQ_STATE_ATTENTION_SIGNAL) {
+      libsame_samples_gen(&synth_ctx, synth_samples);
+      libsame_samples_gen(&cached_ctx, cached_samples);
+
+      for (size_t i = 0; i < LIBSAME_SAMPLES_NUM_MAX; ++i, ++pos) {
+        if (pos < SAMPLE_RATE) {
+          ASSERT_EQ(cached_samples[i], synth_samples[i])
+              << engine << ' ' << pos;
+        } else if (pos < header.attn_sig_duration * SAMPLE_RATE) {
+          ASSERT_EQ(cached_samples[i], tile.samples[pos % SAMPLE_RATE])
+              << engine << ' ' << pos;
+        }
+      }
+    }
+  }
+}
+
+/// Verifies that a tile rendered at another sample rate is ignored.
+TEST(libsame_ctx_attn_sig_tile_set, MismatchedTileIsIgnored) {
+  ctxs_init(LIBSAME_GEN_ENGINE_LIBC, 48000);
+  ctxs_compare();
+}
+
+/// Verifies that libsame_ctx_init() detaches any tile.
+TEST(libsame_ctx_attn_sig_tile_set, CtxInitDetachesTile) {
+  static struct libsame_gen_ctx ctx = {};
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_attn_sig_tile_set(&ctx, &tile);
+  EXPECT_EQ(ctx.attn_sig_tile, &tile);
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  EXPECT_EQ(ctx.attn_sig_tile, nullptr);
+}
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 44100;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+unsigned int app_sin_gen_calls = 0;
+
+s16 app_sin_gen(void *const, const float, const float) {
+  app_sin_gen_calls++;
+  return INT16_MAX;
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that libsame_ctx_init() selects the default generation engine.
+TEST(libsame_ctx_gen_engine_set, CtxInitSelectsDefaultEngine) {
+  struct libsame_gen_ctx ctx = {};
+  ctx.gen_engine = LIBSAME_GEN_ENGINE_APP;
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  EXPECT_EQ(ctx.gen_engine, libsame_gen_engine_get());
+}
+
+/// Verifies that the selected generation engine is stored in the context.
+TEST(libsame_ctx_gen_engine_set, EngineIsSet) {
+  struct libsame_gen_ctx ctx = {};
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+
+  for (int engine = 0; engine < LIBSAME_GEN_ENGINE_NUM; ++engine) {
+    libsame_ctx_gen_engine_set(&ctx,
+                               static_cast<enum libsame_gen_engine>(engine));
+    EXPECT_EQ(ctx.gen_engine, engine);
+  }
+}
+
+/// Verifies that every generation engine produces audio within the same build
+/// of the library.
+TEST(libsame_ctx_gen_engine_set, EveryEngineGeneratesAudio) {
+  libsame_init();
+
+  for (int engine = 0; engine < LIBSAME_GEN_ENGINE_NUM; ++engine) {
+    struct libsame_gen_ctx ctx = {};
+    s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+    ctx.sin_gen = app_sin_gen;
+
+    libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+    libsame_ctx_gen_engine_set(&ctx,
+                               static_cast<enum libsame_gen_engine>(engine));
+    libsame_samples_gen(&ctx, samples);
+
+    bool audible = false;
+
+    for (const s16 sample : samples) {
+      if (sample != 0) {
+        audible = true;
+        break;
+      }
+    }
+    EXPECT_TRUE(audible) << libsame_gen_engine_desc_lookup(
+        static_cast<enum libsame_gen_engine>(engine));
+  }
+}
+
+/// Verifies that the application specified generator is only called when the
+/// application specified generation engine is selected.
+TEST(libsame_ctx_gen_engine_set, AppGeneratorCalledOnlyWhenSelected) {
+  struct libsame_gen_ctx ctx = {};
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX];
+  ctx.sin_gen = app_sin_gen;
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_LIBC);
+
+  app_sin_gen_calls = 0;
+  libsame_samples_gen(&ctx, samples);
+  EXPECT_EQ(app_sin_gen_calls, 0);
+
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_APP);
+  libsame_samples_gen(&ctx, samples);
+  EXPECT_EQ(app_sin_gen_calls, LIBSAME_SAMPLES_NUM_MAX);
+}
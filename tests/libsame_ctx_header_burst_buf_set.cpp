@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+
+#include "ctx_cache_fixture.h"
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+std::vector<s16> buf;
+
+/// Prepares one generation context to synthesize every AFSK header burst and
+/// another to capture the first in a buffer of the specified size.
+///
+/// @returns The number of samples in an AFSK header burst.
+size_t ctxs_init(const enum libsame_gen_engine engine, const size_t buf_num) {
+  ctxs_prepare(engine);
+
+  buf.assign(buf_num, 0);
+  libsame_ctx_header_burst_buf_set(&cached_ctx, buf.data(), buf.size());
+
+  return cached_ctx.seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST];
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that copying the second and third AFSK header bursts from the
+/// first produces exactly the same samples as synthesizing them.
+TEST(libsame_ctx_header_burst_buf_set, BurstsAreExact) {
+  for (int engine = 0; engine < LIBSAME_GEN_ENGINE_NUM; ++engine) {
+    if (engine == LIBSAME_GEN_ENGINE_APP) {
+      continue;
+    }
+    SCOPED_TRACE(engine);
+
+    const size_t burst_num = ctxs_init(
+        static_cast<enum libsame_gen_engine>(engine),
+        LIBSAME_HEADER_BURST_SAMPLES_MAX);
+
+    ctxs_compare();
+    EXPECT_EQ(cached_ctx.header_burst_captured, burst_num);
+  }
+}
+
+/// Verifies that the first AFSK header burst fits in
+/// LIBSAME_HEADER_BURST_SAMPLES_MAX samples.
+TEST(libsame_ctx_header_burst_buf_set, BurstFitsMax) {
+  static struct libsame_gen_ctx ctx = {};
+  struct libsame_header longest = header;
+
+  for (size_t i = 0; i < LIBSAME_LOCATION_CODES_NUM_MAX; ++i) {
+    std::memcpy(longest.location_codes[i], "123456",
+                sizeof(longest.location_codes[i]));
+  }
+
+  libsame_ctx_init(&ctx, &longest, LIBSAME_SAMPLE_RATE_MAX);
+
+  EXPECT_LE(ctx.seq_samples_remaining[LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST],
+            LIBSAME_HEADER_BURST_SAMPLES_MAX);
+}
+
+/// Verifies that a buffer too small for the whole burst is ignored.
+TEST(libsame_ctx_header_burst_buf_set, SmallBufferIsIgnored) {
+  const size_t burst_num = ctxs_init(LIBSAME_GEN_ENGINE_LIBC, 0);
+  ctxs_init(LIBSAME_GEN_ENGINE_LIBC, burst_num - 1);
+
+  ctxs_compare();
+  EXPECT_EQ(cached_ctx.header_burst_captured, 0);
+}
+
+/// Verifies that libsame_ctx_init() detaches any buffer.
+TEST(libsame_ctx_header_burst_buf_set, CtxInitDetachesBuffer) {
+  static struct libsame_gen_ctx ctx = {};
+  static s16 data[LIBSAME_SAMPLES_NUM_MAX];
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_header_burst_buf_set(&ctx, data, LIBSAME_SAMPLES_NUM_MAX);
+  EXPECT_EQ(ctx.header_burst_buf, data);
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  EXPECT_EQ(ctx.header_burst_buf, nullptr);
+  EXPECT_EQ(ctx.header_burst_buf_num, 0);
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every generation engine has a description.
+TEST(libsame_gen_engine_desc_lookup, EveryEngineIsDescribed) {
+  for (int engine = 0; engine < LIBSAME_GEN_ENGINE_NUM; ++engine) {
+    const char *const desc = libsame_gen_engine_desc_lookup(
+        static_cast<enum libsame_gen_engine>(engine));
+
+    ASSERT_NE(desc, nullptr);
+    EXPECT_GT(std::strlen(desc), 0);
+  }
+}
+
+/// Verifies that the description of the default generation engine matches the
+/// one returned by libsame_gen_engine_desc_get().
+TEST(libsame_gen_engine_desc_lookup, DefaultEngineMatchesDescGet) {
+  EXPECT_STREQ(libsame_gen_engine_desc_lookup(libsame_gen_engine_get()),
+               libsame_gen_engine_desc_get());
+}
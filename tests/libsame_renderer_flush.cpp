@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+#include "renderer_fixture.h"
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that flushing a running renderer discards the rest of the message
+/// and leaves only silence to read.
+TEST(libsame_renderer_flush, Running) {
+  renderer_prepare();
+  std::vector<s16> dst(HIGH_WATER, 1);
+
+  ASSERT_TRUE(libsame_renderer_start(&renderer));
+  libsame_renderer_flush(&renderer);
+
+  EXPECT_EQ(libsame_renderer_read(&renderer, dst.data(), dst.size()), 0);
+  EXPECT_TRUE(std::all_of(dst.begin(), dst.end(),
+                          [](const s16 sample) { return sample == 0; }));
+
+  renderer_drain();
+  libsame_renderer_stop(&renderer);
+
+  EXPECT_TRUE(libsame_renderer_done(&renderer));
+  EXPECT_EQ(ctx.seq_state, LIBSAME_SEQ_STATE_NUM);
+}
+
+/// Verifies that flushing a renderer which is not running makes it done.
+TEST(libsame_renderer_flush, Stopped) {
+  renderer_prepare();
+  std::vector<s16> dst(HIGH_WATER);
+
+  ASSERT_TRUE(libsame_renderer_start(&renderer));
+  libsame_renderer_stop(&renderer);
+  libsame_renderer_flush(&renderer);
+
+  EXPECT_FALSE(libsame_renderer_done(&renderer));
+  EXPECT_EQ(libsame_renderer_read(&renderer, dst.data(), dst.size()), 0);
+  EXPECT_TRUE(libsame_renderer_done(&renderer));
+}
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+#include "renderer_fixture.h"
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the ring buffer is filled before the worker thread starts.
+TEST(libsame_renderer_start, Prefills) {
+  renderer_prepare();
+
+  ASSERT_TRUE(libsame_renderer_start(&renderer));
+  EXPECT_GE(libsame_stream_buffered(&renderer.stream), LOW_WATER);
+
+  libsame_renderer_flush(&renderer);
+  renderer_drain();
+  libsame_renderer_stop(&renderer);
+}
+
+/// Verifies that the audio thread reads exactly the samples
+/// libsame_samples_gen_buf() generates while the worker thread renders them.
+TEST(libsame_renderer_start, MatchesSamplesGenBuf) {
+  const std::vector<s16> expected = renderer_prepare();
+
+  ASSERT_TRUE(libsame_renderer_start(&renderer));
+  const std::vector<s16> samples = renderer_drain();
+  libsame_renderer_stop(&renderer);
+
+  EXPECT_EQ(samples, expected);
+}
@@ -20,9 +20,96 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "libsame/libsame.h"
 
+namespace {
+/// Defines a whole message generated by message_gen().
+struct message {
+  /// The samples of the message.
+  std::vector<s16> samples;
+
+  /// The offset of each sequence state within the samples.
+  std::array<size_t, LIBSAME_SEQ_STATE_NUM + 1> offsets;
+};
+
+/// Generates a whole message.
+///
+/// @param engine The generation engine to use.
+/// @param sample_rate The sample rate to use.
+/// @param templates The AFSK bit templates to copy AFSK bits from, if any.
+/// @returns The generated message.
+message message_gen(
+    const enum libsame_gen_engine engine, const unsigned int sample_rate,
+    const struct libsame_afsk_templates *const templates = nullptr) {
+  const struct libsame_header header = {
+      .location_codes = {"101010", "828282", LIBSAME_LOCATION_CODE_END_MARKER},
+      .valid_time_period = "2138",
+      .originator_code = "ORG",
+      .event_code = "RED",
+      .callsign = "XIPHIAS ",
+      .originator_time = "3939393",
+      .attn_sig_duration = 8};
+
+  struct libsame_gen_ctx ctx = {};
+  s16 chunk[LIBSAME_SAMPLES_NUM_MAX];
+  message msg;
+
+  libsame_ctx_init(&ctx, &header, sample_rate);
+  libsame_ctx_gen_engine_set(&ctx, engine);
+  libsame_ctx_afsk_templates_set(&ctx, templates);
+
+  msg.offsets[0] = 0;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    msg.offsets[state + 1] =
+        msg.offsets[state] + ctx.seq_samples_remaining[state];
+  }
+
+  while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+    libsame_samples_gen(&ctx, chunk);
+    msg.samples.insert(msg.samples.end(), std::begin(chunk), std::end(chunk));
+  }
+  msg.samples.resize(msg.offsets[LIBSAME_SEQ_STATE_NUM]);
+  return msg;
+}
+
+/// Verifies that every EOM burst of a message is the same, and starts with the
+/// same samples as the preamble of the synthesized header bursts.
+///
+/// @param msg The message to verify.
+void eom_bursts_verify(const message &msg) {
+  const auto burst = [&msg](const enum libsame_seq_state state) {
+    return msg.samples.begin() + static_cast<ptrdiff_t>(msg.offsets[state]);
+  };
+
+  const size_t eom_num = msg.offsets[LIBSAME_SEQ_STATE_AFSK_EOM_FIRST + 1] -
+                         msg.offsets[LIBSAME_SEQ_STATE_AFSK_EOM_FIRST];
+
+  // The preamble is all but the last 4 characters of the EOM header.
+  const size_t preamble_num =
+      eom_num / (LIBSAME_PREAMBLE_NUM + 4) * LIBSAME_PREAMBLE_NUM;
+
+  const auto first = burst(LIBSAME_SEQ_STATE_AFSK_EOM_FIRST);
+
+  ASSERT_TRUE(std::equal(first, first + static_cast<ptrdiff_t>(preamble_num),
+                         burst(LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST)));
+
+  for (const auto state :
+       {LIBSAME_SEQ_STATE_AFSK_EOM_SECOND, LIBSAME_SEQ_STATE_AFSK_EOM_THIRD}) {
+    ASSERT_TRUE(std::equal(first, first + static_cast<ptrdiff_t>(eom_num),
+                           burst(state)))
+        << state;
+  }
+}
+}  // namespace
+
 #ifndef NDEBUG
 void *libsame_dbg_userdata_ = nullptr;
 
@@ -53,7 +140,7 @@ class SeqStateTransitionTest : public ::testing::Test {
     unsigned int count = 0;
 
     while (count < num_samples_expected) {
-      libsame_samples_gen(&ctx);
+      libsame_samples_gen(&ctx, samples);
       count += LIBSAME_SAMPLES_NUM_MAX;
     }
     EXPECT_EQ(ctx.seq_state, expected_state);
@@ -70,6 +157,7 @@ class SeqStateTransitionTest : public ::testing::Test {
       .attn_sig_duration = 8};
 
   struct libsame_gen_ctx ctx = {};
+  s16 samples[LIBSAME_SAMPLES_NUM_MAX] = {};
 };
 
 /// Verifies that the first AFSK header burst transitions to the first silence
@@ -120,3 +208,301 @@ TEST_F(SeqStateTransitionTest, ThirdEOMHeaderToSeventhSilence) {
   VerifyTransition(LIBSAME_SEQ_STATE_AFSK_EOM_THIRD,
                    LIBSAME_SEQ_STATE_SILENCE_SEVENTH);
 }
+
+/// Verifies that the SIMD generation engine produces the same waveform as the
+/// libc generation engine, give or take rounding.
+TEST(libsame_samples_gen, SIMDEngineMatchesLibc) {
+  const struct libsame_header header = {
+      .location_codes = {"101010", "828282", LIBSAME_LOCATION_CODE_END_MARKER},
+      .valid_time_period = "2138",
+      .originator_code = "ORG",
+      .event_code = "RED",
+      .callsign = "XIPHIAS ",
+      .originator_time = "3939393",
+      .attn_sig_duration = 8};
+
+  static struct libsame_gen_ctx libc_ctx = {};
+  static s16 libc_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+  static struct libsame_gen_ctx simd_ctx = {};
+  static s16 simd_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+
+  libsame_init();
+
+  libsame_ctx_init(&libc_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&libc_ctx, LIBSAME_GEN_ENGINE_LIBC);
+
+  libsame_ctx_init(&simd_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&simd_ctx, LIBSAME_GEN_ENGINE_SIMD);
+
+  libsame_samples_gen(&libc_ctx, libc_samples);
+  libsame_samples_gen(&simd_ctx, simd_samples);
+
+  for (size_t i = 0; i < LIBSAME_SAMPLES_NUM_MAX; ++i) {
+    EXPECT_NEAR(simd_samples[i], libc_samples[i], 1) << i;
+  }
+}
+
+/// Verifies that the DDS generation engine produces the same attention signal
+/// as the libc generation engine, give or take rounding.
+TEST(libsame_samples_gen, DDSEngineMatchesLibc) {
+  const struct libsame_header header = {
+      .location_codes = {"101010", "828282", LIBSAME_LOCATION_CODE_END_MARKER},
+      .valid_time_period = "2138",
+      .originator_code = "ORG",
+      .event_code = "RED",
+      .callsign = "XIPHIAS ",
+      .originator_time = "3939393",
+      .attn_sig_duration = 8};
+
+  static struct libsame_gen_ctx libc_ctx = {};
+  static s16 libc_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+  static struct libsame_gen_ctx dds_ctx = {};
+  static s16 dds_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+  static struct libsame_segment_map map = {};
+
+  libsame_init();
+  libsame_segment_map_get(&map, &header, 44100);
+
+  // The DDS engine keeps its phase across AFSK bits where the libc engine
+  // restarts it, so compare over the attention signal where both generate a
+  // continuous tone from the same starting phase.
+  const size_t attn_sig_start =
+      map.segments[LIBSAME_SEQ_STATE_ATTENTION_SIGNAL].start;
+
+  libsame_ctx_init(&libc_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&libc_ctx, LIBSAME_GEN_ENGINE_LIBC);
+  libsame_seek(&libc_ctx, attn_sig_start);
+
+  libsame_ctx_init(&dds_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&dds_ctx, LIBSAME_GEN_ENGINE_DDS);
+  libsame_seek(&dds_ctx, attn_sig_start);
+
+  EXPECT_EQ(dds_ctx.phase_incs[0], 202895813U);
+
+  libsame_samples_gen(&libc_ctx, libc_samples);
+  libsame_samples_gen(&dds_ctx, dds_samples);
+
+  for (size_t i = 0; i < LIBSAME_SAMPLES_NUM_MAX; ++i) {
+    EXPECT_NEAR(dds_samples[i], libc_samples[i], 8) << i;
+  }
+}
+
+/// Verifies that the rotator generation engine switches between the mark and
+/// space frequencies without losing phase, by comparing it against the DDS
+/// generation engine.
+TEST(libsame_samples_gen, RotatorEngineMatchesDDS) {
+  const struct libsame_header header = {
+      .location_codes = {"101010", "828282", LIBSAME_LOCATION_CODE_END_MARKER},
+      .valid_time_period = "2138",
+      .originator_code = "ORG",
+      .event_code = "RED",
+      .callsign = "XIPHIAS ",
+      .originator_time = "3939393",
+      .attn_sig_duration = 8};
+
+  static struct libsame_gen_ctx dds_ctx = {};
+  static s16 dds_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+  static struct libsame_gen_ctx rotator_ctx = {};
+  static s16 rotator_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+
+  libsame_init();
+
+  // Both engines keep their phase across AFSK bits and run at the same
+  // quantized frequencies, so they must agree over the whole header.
+  libsame_ctx_init(&dds_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&dds_ctx, LIBSAME_GEN_ENGINE_DDS);
+
+  libsame_ctx_init(&rotator_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&rotator_ctx, LIBSAME_GEN_ENGINE_ROTATOR);
+
+  while (dds_ctx.seq_state == LIBSAME_SEQ_STATE_AFSK_HEADER_FIRST) {
+    libsame_samples_gen(&dds_ctx, dds_samples);
+    libsame_samples_gen(&rotator_ctx, rotator_samples);
+
+    for (size_t i = 0; i < LIBSAME_SAMPLES_NUM_MAX; ++i) {
+      ASSERT_NEAR(rotator_samples[i], dds_samples[i], 8) << i;
+    }
+  }
+}
+
+/// Verifies that both polynomial generation engines produce the same waveform
+/// as the DDS generation engine over a whole message, give or take rounding.
+TEST(libsame_samples_gen, PolyEnginesMatchDDS) {
+  const struct libsame_header header = {
+      .location_codes = {"101010", "828282", LIBSAME_LOCATION_CODE_END_MARKER},
+      .valid_time_period = "2138",
+      .originator_code = "ORG",
+      .event_code = "RED",
+      .callsign = "XIPHIAS ",
+      .originator_time = "3939393",
+      .attn_sig_duration = 8};
+
+  static struct libsame_gen_ctx dds_ctx = {};
+  static s16 dds_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+  static struct libsame_gen_ctx poly_ctx = {};
+  static s16 poly_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+  static struct libsame_gen_ctx poly_fixed_ctx = {};
+  static s16 poly_fixed_samples[LIBSAME_SAMPLES_NUM_MAX] = {};
+
+  libsame_init();
+
+  libsame_ctx_init(&dds_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&dds_ctx, LIBSAME_GEN_ENGINE_DDS);
+
+  libsame_ctx_init(&poly_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&poly_ctx, LIBSAME_GEN_ENGINE_POLY);
+
+  libsame_ctx_init(&poly_fixed_ctx, &header, 44100);
+  libsame_ctx_gen_engine_set(&poly_fixed_ctx, LIBSAME_GEN_ENGINE_POLY_FIXED);
+
+  while (dds_ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+    libsame_samples_gen(&dds_ctx, dds_samples);
+    libsame_samples_gen(&poly_ctx, poly_samples);
+    libsame_samples_gen(&poly_fixed_ctx, poly_fixed_samples);
+
+    for (size_t i = 0; i < LIBSAME_SAMPLES_NUM_MAX; ++i) {
+      ASSERT_NEAR(poly_samples[i], dds_samples[i], 4) << i;
+      ASSERT_NEAR(poly_fixed_samples[i], poly_samples[i], 3)
+          << i;
+    }
+  }
+}
+
+/// Verifies that EOM bursts served from the EOM burst cache are exactly what
+/// every generation engine synthesizes, for the message which populates the
+/// cache and for the ones after it.
+TEST(libsame_samples_gen, EOMBurstsMatchSynthesis) {
+  libsame_init();
+
+  for (int engine = 0; engine < LIBSAME_GEN_ENGINE_NUM; ++engine) {
+    if (engine == LIBSAME_GEN_ENGINE_APP) {
+      continue;
+    }
+
+    SCOPED_TRACE(engine);
+
+    for (int i = 0; i < 2; ++i) {
+      eom_bursts_verify(
+          message_gen(static_cast<enum libsame_gen_engine>(engine), 8000));
+    }
+  }
+}
+
+/// Verifies that EOM bursts are still synthesized at sample rates above
+/// LIBSAME_SAMPLE_RATE_MAX, which the EOM burst cache has no room for.
+TEST(libsame_samples_gen, EOMBurstsAboveSampleRateMax) {
+  libsame_init();
+
+  for (int i = 0; i < 2; ++i) {
+    eom_bursts_verify(
+        message_gen(LIBSAME_GEN_ENGINE_DDS, LIBSAME_SAMPLE_RATE_MAX * 2));
+  }
+}
+
+/// Verifies that a generation context with AFSK bit templates attached
+/// synthesizes its EOM bursts exactly when they miss a full EOM burst cache,
+/// just as the bursts the cache holds were synthesized.
+TEST(libsame_samples_gen, EOMBurstsIgnoreTemplates) {
+  constexpr unsigned int SAMPLE_RATE = 12345;
+
+  libsame_init();
+
+  // Fill every slot of the EOM burst cache with other sample rates.
+  for (unsigned int rate = 9000; rate < 9064; ++rate) {
+    message_gen(LIBSAME_GEN_ENGINE_DDS, rate);
+  }
+
+  static struct libsame_afsk_templates templates = {};
+  const message msg = message_gen(LIBSAME_GEN_ENGINE_DDS, SAMPLE_RATE);
+  struct libsame_gen_ctx ctx = {};
+  const struct libsame_header header = {
+      .location_codes = {"101010", LIBSAME_LOCATION_CODE_END_MARKER},
+      .valid_time_period = "2138",
+      .originator_code = "ORG",
+      .event_code = "RED",
+      .callsign = "XIPHIAS ",
+      .originator_time = "3939393",
+      .attn_sig_duration = 8};
+
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_DDS);
+  libsame_afsk_templates_init(&templates, &ctx);
+
+  const message templated =
+      message_gen(LIBSAME_GEN_ENGINE_DDS, SAMPLE_RATE, &templates);
+
+  ASSERT_EQ(templated.offsets, msg.offsets);
+
+  for (const auto state :
+       {LIBSAME_SEQ_STATE_AFSK_EOM_FIRST, LIBSAME_SEQ_STATE_AFSK_EOM_SECOND,
+        LIBSAME_SEQ_STATE_AFSK_EOM_THIRD}) {
+    const auto start = static_cast<ptrdiff_t>(msg.offsets[state]);
+    const auto end = static_cast<ptrdiff_t>(msg.offsets[state + 1]);
+
+    EXPECT_TRUE(std::equal(msg.samples.begin() + start,
+                           msg.samples.begin() + end,
+                           templated.samples.begin() + start))
+        << state;
+  }
+}
+
+/// Verifies that messages generated on many threads at once, populating the
+/// EOM burst cache concurrently and overflowing it, come out the same as ones
+/// generated afterwards on a single thread.
+TEST(libsame_samples_gen, EOMCacheIsThreadSafe) {
+  libsame_init();
+
+  const std::vector<std::pair<enum libsame_gen_engine, unsigned int>> configs =
+      {{LIBSAME_GEN_ENGINE_LIBC, 8000},  {LIBSAME_GEN_ENGINE_LIBC, 11025},
+       {LIBSAME_GEN_ENGINE_DDS, 8000},   {LIBSAME_GEN_ENGINE_DDS, 11025},
+       {LIBSAME_GEN_ENGINE_POLY, 8000},  {LIBSAME_GEN_ENGINE_POLY, 11025},
+       {LIBSAME_GEN_ENGINE_SIMD, 8000},  {LIBSAME_GEN_ENGINE_SIMD, 11025}};
+
+  constexpr size_t THREADS_PER_CONFIG = 2;
+
+  std::vector<message> msgs(configs.size() * THREADS_PER_CONFIG);
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    threads.emplace_back([&msgs, &configs, i] {
+      const auto &config = configs[i % configs.size()];
+      msgs[i] = message_gen(config.first, config.second);
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    const auto &config = configs[i % configs.size()];
+
+    eom_bursts_verify(msgs[i]);
+    EXPECT_EQ(msgs[i].samples,
+              message_gen(config.first, config.second).samples)
+        << i;
+  }
+}
+
+/// Verifies that every silence period is generated as silence, including when
+/// it begins or ends partway through a chunk.
+TEST(libsame_samples_gen, SilenceIsZero) {
+  for (const unsigned int sample_rate : {8000U, 11025U, 44100U}) {
+    const message msg = message_gen(LIBSAME_GEN_ENGINE_DDS, sample_rate);
+
+    for (const auto state :
+         {LIBSAME_SEQ_STATE_SILENCE_FIRST, LIBSAME_SEQ_STATE_SILENCE_SECOND,
+          LIBSAME_SEQ_STATE_SILENCE_THIRD, LIBSAME_SEQ_STATE_SILENCE_FOURTH,
+          LIBSAME_SEQ_STATE_SILENCE_FIFTH, LIBSAME_SEQ_STATE_SILENCE_SIXTH,
+          LIBSAME_SEQ_STATE_SILENCE_SEVENTH}) {
+      const auto begin =
+          msg.samples.begin() + static_cast<ptrdiff_t>(msg.offsets[state]);
+      const auto end =
+          msg.samples.begin() + static_cast<ptrdiff_t>(msg.offsets[state + 1]);
+
+      ASSERT_NE(begin, end) << state;
+      EXPECT_TRUE(std::all_of(begin, end, [](const s16 s) { return s == 0; }))
+          << sample_rate << ' ' << state;
+    }
+  }
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+/// The number of generation contexts in the batch; more than are grouped at
+/// once.
+constexpr size_t CTXS_NUM = 70;
+
+/// The sample rates the generation contexts cycle through.
+constexpr unsigned int SAMPLE_RATES[] = {8000, 11025, 22050};
+
+/// The generation engines the generation contexts cycle through. The
+/// application specified generation engine needs a generator of its own, so
+/// it is left out.
+constexpr enum libsame_gen_engine GEN_ENGINES[] = {
+    LIBSAME_GEN_ENGINE_LIBC,     LIBSAME_GEN_ENGINE_LUT,
+    LIBSAME_GEN_ENGINE_POLY,     LIBSAME_GEN_ENGINE_SIMD,
+    LIBSAME_GEN_ENGINE_DDS,      LIBSAME_GEN_ENGINE_ROTATOR,
+    LIBSAME_GEN_ENGINE_POLY_FIXED};
+
+struct libsame_gen_ctx ctxs[CTXS_NUM] = {};
+
+/// Prepares every generation context, each at a different sample rate,
+/// generation engine and position within its message.
+void ctxs_prepare() {
+  libsame_init();
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    std::memset(&ctxs[i], 0, sizeof(ctxs[i]));
+    libsame_ctx_init(&ctxs[i], &header, SAMPLE_RATES[i % 3]);
+    libsame_ctx_gen_engine_set(&ctxs[i], GEN_ENGINES[i % 7]);
+    libsame_seek(&ctxs[i], i * 3001);
+  }
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every generation context of a batch produces exactly the
+/// samples libsame_samples_gen_buf() produces for it.
+TEST(libsame_samples_gen_batch, MatchesSamplesGenBuf) {
+  ctxs_prepare();
+
+  struct libsame_gen_ctx refs[CTXS_NUM];
+  std::memcpy(refs, ctxs, sizeof(refs));
+
+  struct libsame_gen_ctx *ptrs[CTXS_NUM];
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    ptrs[i] = &ctxs[i];
+  }
+
+  constexpr size_t NUM = 5000;
+  std::vector<s16> samples(CTXS_NUM * NUM);
+  std::vector<s16> expected(NUM);
+  size_t generated[CTXS_NUM];
+  size_t total;
+
+  while ((total = libsame_samples_gen_batch(ptrs, CTXS_NUM, samples.data(),
+                                            NUM, generated)) != 0) {
+    size_t expected_total = 0;
+
+    for (size_t i = 0; i < CTXS_NUM; ++i) {
+      SCOPED_TRACE(i);
+
+      const size_t num =
+          libsame_samples_gen_buf(&refs[i], expected.data(), NUM);
+
+      ASSERT_EQ(generated[i], num);
+      ASSERT_EQ(std::memcmp(&samples[i * NUM], expected.data(),
+                            num * sizeof(s16)),
+                0);
+      ASSERT_EQ(ctxs[i].seq_state, refs[i].seq_state);
+      expected_total += num;
+    }
+    EXPECT_EQ(total, expected_total);
+  }
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    EXPECT_EQ(ctxs[i].seq_state, LIBSAME_SEQ_STATE_NUM);
+  }
+}
+
+/// Verifies that an empty batch generates nothing.
+TEST(libsame_samples_gen_batch, Empty) {
+  EXPECT_EQ(libsame_samples_gen_batch(nullptr, 0, nullptr, 0, nullptr), 0);
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 11025;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_gen_ctx ctx = {};
+
+/// Prepares the generation context to generate a new message.
+///
+/// @returns The number of samples in the message.
+size_t ctx_prepare() {
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_DDS);
+
+  size_t total = 0;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    total += ctx.seq_samples_remaining[state];
+  }
+  return total;
+}
+
+/// Generates a whole message using libsame_samples_gen().
+std::vector<s16> message_gen() {
+  const size_t total = ctx_prepare();
+  s16 chunk[LIBSAME_SAMPLES_NUM_MAX];
+  std::vector<s16> samples;
+
+  while (ctx.seq_state != LIBSAME_SEQ_STATE_NUM) {
+    libsame_samples_gen(&ctx, chunk);
+    samples.insert(samples.end(), std::begin(chunk), std::end(chunk));
+  }
+  samples.resize(total);
+  return samples;
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that generating into buffers of any length produces exactly the
+/// same samples as libsame_samples_gen().
+TEST(libsame_samples_gen_buf, MatchesSamplesGen) {
+  const std::vector<s16> expected = message_gen();
+
+  for (const size_t buf_num :
+       {1U, 7U, 256U, LIBSAME_SAMPLES_NUM_MAX, 10000U}) {
+    SCOPED_TRACE(buf_num);
+    ctx_prepare();
+
+    std::vector<s16> samples;
+    std::vector<s16> buf(buf_num);
+    size_t num;
+
+    while ((num = libsame_samples_gen_buf(&ctx, buf.data(), buf.size())) != 0) {
+      samples.insert(samples.end(), buf.begin(),
+                     buf.begin() + static_cast<ptrdiff_t>(num));
+    }
+    EXPECT_EQ(samples, expected);
+  }
+}
+
+/// Verifies that the number of samples generated is short only at the end of
+/// the sequence, and zero afterwards.
+TEST(libsame_samples_gen_buf, ReturnsSamplesGenerated) {
+  const size_t total = ctx_prepare();
+  std::vector<s16> buf(total + 100);
+
+  EXPECT_EQ(libsame_samples_gen_buf(&ctx, buf.data(), total - 1), total - 1);
+  EXPECT_EQ(libsame_samples_gen_buf(&ctx, buf.data(), buf.size()), 1);
+  EXPECT_EQ(ctx.seq_state, LIBSAME_SEQ_STATE_NUM);
+  EXPECT_EQ(libsame_samples_gen_buf(&ctx, buf.data(), buf.size()), 0);
+}
+
+/// Verifies that libsame_samples_gen_buf() and libsame_samples_gen() can be
+/// mixed.
+TEST(libsame_samples_gen_buf, MixesWithSamplesGen) {
+  const std::vector<s16> expected = message_gen();
+  ctx_prepare();
+
+  std::vector<s16> samples(expected.size());
+  size_t pos = libsame_samples_gen_buf(&ctx, samples.data(), 1000);
+
+  libsame_samples_gen(&ctx, &samples[pos]);
+  pos += LIBSAME_SAMPLES_NUM_MAX;
+
+  pos += libsame_samples_gen_buf(&ctx, &samples[pos], samples.size() - pos);
+
+  EXPECT_EQ(pos, expected.size());
+  EXPECT_EQ(samples, expected);
+}
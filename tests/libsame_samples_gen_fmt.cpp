@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 11025;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_gen_ctx ctx = {};
+
+/// Prepares the generation context to generate a new message.
+void ctx_prepare() {
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_DDS);
+}
+
+/// Generates a whole message as signed 16-bit samples.
+std::vector<s16> message_gen() {
+  ctx_prepare();
+
+  std::vector<s16> samples;
+  s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  size_t num;
+
+  while ((num = libsame_samples_gen_buf(&ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    samples.insert(samples.end(), buf, buf + num);
+  }
+  return samples;
+}
+
+/// Generates a whole message in an output sample format.
+///
+/// @param fmt The output sample format.
+/// @param buf_num The number of samples to generate per call.
+std::vector<u8> message_gen_fmt(const enum libsame_sample_fmt fmt,
+                                const size_t buf_num) {
+  ctx_prepare();
+
+  const size_t size = libsame_sample_fmt_size_get(fmt);
+  std::vector<u8> data;
+  std::vector<u8> buf(buf_num * size);
+  size_t num;
+
+  while ((num = libsame_samples_gen_fmt(&ctx, fmt, buf.data(), buf_num)) !=
+         0) {
+    data.insert(data.end(), buf.begin(),
+                buf.begin() + static_cast<ptrdiff_t>(num * size));
+  }
+  return data;
+}
+
+/// Decodes one sample of an output sample format back to a signed 16-bit
+/// sample.
+s16 sample_decode(const enum libsame_sample_fmt fmt, const u8 *const data) {
+  switch (fmt) {
+    case LIBSAME_SAMPLE_FMT_S16LE:
+      return static_cast<s16>(data[0] | (data[1] << 8));
+
+    case LIBSAME_SAMPLE_FMT_S16BE:
+      return static_cast<s16>(data[1] | (data[0] << 8));
+
+    case LIBSAME_SAMPLE_FMT_S24LE:
+      EXPECT_EQ(data[0], 0);
+      return static_cast<s16>(data[1] | (data[2] << 8));
+
+    case LIBSAME_SAMPLE_FMT_S32LE:
+      EXPECT_EQ(data[0], 0);
+      EXPECT_EQ(data[1], 0);
+      return static_cast<s16>(data[2] | (data[3] << 8));
+
+    case LIBSAME_SAMPLE_FMT_F32: {
+      float sample;
+      std::memcpy(&sample, data, sizeof(sample));
+
+      EXPECT_GE(sample, -1.0F);
+      EXPECT_LT(sample, 1.0F);
+      return static_cast<s16>(sample * 32768.0F);
+    }
+
+    default:
+      ADD_FAILURE() << fmt;
+      return 0;
+  }
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every output sample format holds exactly the signed 16-bit
+/// samples generated otherwise, whatever the number of samples generated per
+/// call.
+TEST(libsame_samples_gen_fmt, MatchesSamplesGenBuf) {
+  libsame_init();
+
+  const std::vector<s16> expected = message_gen();
+
+  for (int fmt = 0; fmt < LIBSAME_SAMPLE_FMT_NUM; ++fmt) {
+    const auto sample_fmt = static_cast<enum libsame_sample_fmt>(fmt);
+    const size_t size = libsame_sample_fmt_size_get(sample_fmt);
+
+    for (const size_t buf_num : {1U, 255U, 1000U, LIBSAME_SAMPLES_NUM_MAX}) {
+      const std::vector<u8> data = message_gen_fmt(sample_fmt, buf_num);
+
+      ASSERT_EQ(data.size(), expected.size() * size) << fmt << ' ' << buf_num;
+
+      for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(sample_decode(sample_fmt, &data[i * size]), expected[i])
+            << fmt << ' ' << buf_num << ' ' << i;
+      }
+    }
+  }
+}
+
+/// Verifies that the number of samples generated is short only at the end of
+/// the sequence, and zero afterwards.
+TEST(libsame_samples_gen_fmt, ReturnsSamplesGenerated) {
+  const size_t total = message_gen().size();
+  std::vector<float> buf(total + 100);
+
+  ctx_prepare();
+
+  EXPECT_EQ(libsame_samples_gen_fmt(&ctx, LIBSAME_SAMPLE_FMT_F32, buf.data(),
+                                    total - 1),
+            total - 1);
+  EXPECT_EQ(libsame_samples_gen_fmt(&ctx, LIBSAME_SAMPLE_FMT_F32, buf.data(),
+                                    buf.size()),
+            1);
+  EXPECT_EQ(libsame_samples_gen_fmt(&ctx, LIBSAME_SAMPLE_FMT_F32, buf.data(),
+                                    buf.size()),
+            0);
+}
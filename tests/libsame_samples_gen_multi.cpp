@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header headers[] = {
+    {.location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+     .valid_time_period = "1000",
+     .originator_code = "GOD",
+     .event_code = "GOG",
+     .callsign = "HEATISON",
+     .originator_time = "1717777",
+     .attn_sig_duration = 8},
+    {.location_codes = {"048453", LIBSAME_LOCATION_CODE_END_MARKER},
+     .valid_time_period = "0030",
+     .originator_code = "WXR",
+     .event_code = "TOR",
+     .callsign = "KEWX/NWS",
+     .originator_time = "1231200",
+     .attn_sig_duration = 9}};
+
+/// The number of generation contexts; one full group of lanes and a partial
+/// one.
+constexpr size_t CTXS_NUM = 11;
+
+/// The sample rates the generation contexts cycle through.
+constexpr unsigned int SAMPLE_RATES[] = {8000, 11025, 22050, 48000};
+
+struct libsame_gen_ctx ctxs[CTXS_NUM] = {};
+struct libsame_gen_ctx refs[CTXS_NUM] = {};
+struct libsame_gen_ctx *ptrs[CTXS_NUM] = {};
+
+/// The generation engines the generation contexts cycle through when engines
+/// are mixed.
+constexpr enum libsame_gen_engine MIXED_ENGINES[] = {
+    LIBSAME_GEN_ENGINE_POLY, LIBSAME_GEN_ENGINE_DDS, LIBSAME_GEN_ENGINE_POLY,
+    LIBSAME_GEN_ENGINE_ROTATOR, LIBSAME_GEN_ENGINE_LUT};
+
+/// Prepares a generation context.
+void ctx_prepare(struct libsame_gen_ctx *const ctx,
+                 const struct libsame_header *const header,
+                 const unsigned int sample_rate,
+                 const enum libsame_gen_engine engine =
+                     LIBSAME_GEN_ENGINE_POLY) {
+  std::memset(ctx, 0, sizeof(*ctx));
+  libsame_ctx_init(ctx, header, sample_rate);
+  libsame_ctx_gen_engine_set(ctx, engine);
+}
+
+/// Prepares every generation context, each at a different sample rate and
+/// position within its message, and copies them to the reference contexts.
+///
+/// @param mixed Whether the generation contexts cycle through MIXED_ENGINES
+///              instead of all using the polynomial generation engine.
+void ctxs_prepare(const bool mixed = false) {
+  libsame_init();
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    const enum libsame_gen_engine engine =
+        mixed ? MIXED_ENGINES[i % 5] : LIBSAME_GEN_ENGINE_POLY;
+
+    ctx_prepare(&ctxs[i], &headers[i % 2], SAMPLE_RATES[i % 4], engine);
+    libsame_seek(&ctxs[i], i * 4999);
+    ptrs[i] = &ctxs[i];
+  }
+  std::memcpy(refs, ctxs, sizeof(refs));
+}
+
+/// Generates every generation context to the end of its sequence, checking
+/// that every lane holds exactly the samples libsame_samples_gen_buf()
+/// produces for its reference context.
+void frames_verify() {
+  constexpr size_t NUM = 3000;
+  std::vector<s16> frames(CTXS_NUM * NUM);
+  std::vector<s16> expected(NUM);
+  size_t generated[CTXS_NUM];
+  size_t total;
+
+  while ((total = libsame_samples_gen_multi(ptrs, CTXS_NUM, frames.data(), NUM,
+                                            generated)) != 0) {
+    size_t expected_total = 0;
+
+    for (size_t i = 0; i < CTXS_NUM; ++i) {
+      SCOPED_TRACE(i);
+
+      const size_t num =
+          libsame_samples_gen_buf(&refs[i], expected.data(), NUM);
+      ASSERT_EQ(generated[i], num);
+
+      for (size_t f = 0; f < NUM; ++f) {
+        ASSERT_EQ(frames[(f * CTXS_NUM) + i], (f < num) ? expected[f] : 0)
+            << "frame " << f;
+      }
+      ASSERT_EQ(ctxs[i].seq_state, refs[i].seq_state);
+      expected_total += num;
+    }
+    EXPECT_EQ(total, expected_total);
+  }
+
+  for (size_t i = 0; i < CTXS_NUM; ++i) {
+    EXPECT_EQ(ctxs[i].seq_state, LIBSAME_SEQ_STATE_NUM);
+  }
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every lane produces exactly the samples
+/// libsame_samples_gen_buf() produces for its generation context.
+TEST(libsame_samples_gen_multi, MatchesSamplesGenBuf) {
+  ctxs_prepare();
+  frames_verify();
+}
+
+/// Verifies that generation contexts using engines other than the polynomial
+/// one, mixed with ones using it, still produce exactly the samples
+/// libsame_samples_gen_buf() produces for them.
+TEST(libsame_samples_gen_multi, MixedEngines) {
+  ctxs_prepare(true);
+  frames_verify();
+}
+
+/// Verifies that a lane picks up where an AFSK header burst copied from the
+/// header burst buffer left off.
+TEST(libsame_samples_gen_multi, ResumesCopiedBurst) {
+  libsame_init();
+
+  struct libsame_gen_ctx ctx;
+  std::vector<s16> burst(LIBSAME_HEADER_BURST_SAMPLES_MAX);
+
+  ctx_prepare(&ctx, &headers[0], 22050);
+  libsame_ctx_header_burst_buf_set(&ctx, burst.data(), burst.size());
+
+  // Generate the first header burst and part of the second, which is copied.
+  while (ctx.seq_state != LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND) {
+    s16 sample;
+    libsame_samples_gen_buf(&ctx, &sample, 1);
+  }
+
+  std::vector<s16> skipped(777);
+  libsame_samples_gen_buf(&ctx, skipped.data(), skipped.size());
+
+  struct libsame_gen_ctx ref = ctx;
+  struct libsame_gen_ctx *ptr = &ctx;
+
+  constexpr size_t NUM = 20000;
+  std::vector<s16> samples(NUM);
+  std::vector<s16> expected(NUM);
+
+  ASSERT_EQ(libsame_samples_gen_multi(&ptr, 1, samples.data(), NUM, nullptr),
+            NUM);
+  ASSERT_EQ(libsame_samples_gen_buf(&ref, expected.data(), NUM), NUM);
+  EXPECT_EQ(samples, expected);
+}
+
+/// Verifies that an empty set of generation contexts generates nothing.
+TEST(libsame_samples_gen_multi, Empty) {
+  EXPECT_EQ(libsame_samples_gen_multi(nullptr, 0, nullptr, 0, nullptr), 0);
+}
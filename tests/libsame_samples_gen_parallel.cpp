@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+/// The generation engines to render with. The application specified
+/// generation engine needs a generator of its own, so it is left out.
+constexpr enum libsame_gen_engine GEN_ENGINES[] = {
+    LIBSAME_GEN_ENGINE_LIBC,     LIBSAME_GEN_ENGINE_LUT,
+    LIBSAME_GEN_ENGINE_POLY,     LIBSAME_GEN_ENGINE_SIMD,
+    LIBSAME_GEN_ENGINE_DDS,      LIBSAME_GEN_ENGINE_ROTATOR,
+    LIBSAME_GEN_ENGINE_POLY_FIXED};
+
+/// Prepares a generation context at the start of the message.
+void ctx_prepare(struct libsame_gen_ctx *const ctx,
+                 const enum libsame_gen_engine engine,
+                 const unsigned int sample_rate) {
+  libsame_init();
+
+  std::memset(ctx, 0, sizeof(*ctx));
+  libsame_ctx_init(ctx, &header, sample_rate);
+  libsame_ctx_gen_engine_set(ctx, engine);
+}
+
+/// Renders a whole message in order on the calling thread.
+std::vector<s16> serial_render(struct libsame_gen_ctx ctx) {
+  std::vector<s16> samples;
+  s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  size_t num;
+
+  while ((num = libsame_samples_gen_buf(&ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    samples.insert(samples.end(), buf, buf + num);
+  }
+  return samples;
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every generation engine renders exactly the samples the
+/// serial path renders, no matter how many threads are used.
+TEST(libsame_samples_gen_parallel, MatchesSerial) {
+  constexpr unsigned int THREADS_NUMS[] = {1, 2, 3, 4, 7, 16, 64};
+
+  for (const auto engine : GEN_ENGINES) {
+    struct libsame_gen_ctx ctx;
+    ctx_prepare(&ctx, engine, 11025);
+
+    const std::vector<s16> expected = serial_render(ctx);
+
+    for (const auto threads_num : THREADS_NUMS) {
+      SCOPED_TRACE(engine);
+      SCOPED_TRACE(threads_num);
+
+      std::vector<s16> samples(expected.size() + 100, 1);
+
+      ASSERT_EQ(libsame_samples_gen_parallel(&ctx, samples.data(),
+                                             samples.size(), threads_num),
+                expected.size());
+      ASSERT_TRUE(std::equal(expected.begin(), expected.end(),
+                             samples.begin()));
+
+      // Samples past the end of the message are left untouched.
+      EXPECT_EQ(samples.back(), 1);
+    }
+  }
+}
+
+/// Verifies that rendering stops once the buffer is full.
+TEST(libsame_samples_gen_parallel, StopsAtBufferEnd) {
+  struct libsame_gen_ctx ctx;
+  ctx_prepare(&ctx, LIBSAME_GEN_ENGINE_DDS, 8000);
+
+  const std::vector<s16> expected = serial_render(ctx);
+
+  for (const size_t num : {size_t{0}, size_t{1}, size_t{12345},
+                           expected.size() / 2, expected.size() - 1}) {
+    SCOPED_TRACE(num);
+
+    std::vector<s16> samples(num + 1, 1);
+
+    ASSERT_EQ(libsame_samples_gen_parallel(&ctx, samples.data(), num, 4), num);
+    ASSERT_TRUE(std::equal(samples.begin(), samples.begin() + num,
+                           expected.begin()));
+    EXPECT_EQ(samples[num], 1);
+  }
+}
+
+/// Verifies that the header burst buffer and AFSK bit templates attached to a
+/// generation context are used by every thread.
+TEST(libsame_samples_gen_parallel, SharesAttachments) {
+  struct libsame_gen_ctx ctx;
+  ctx_prepare(&ctx, LIBSAME_GEN_ENGINE_LUT, 22050);
+
+  static struct libsame_afsk_templates templates;
+  std::vector<s16> burst(LIBSAME_HEADER_BURST_SAMPLES_MAX);
+
+  libsame_afsk_templates_init(&templates, &ctx);
+  libsame_ctx_afsk_templates_set(&ctx, &templates);
+  libsame_ctx_header_burst_buf_set(&ctx, burst.data(), burst.size());
+
+  const std::vector<s16> expected = serial_render(ctx);
+  std::vector<s16> samples(expected.size());
+
+  ASSERT_EQ(libsame_samples_gen_parallel(&ctx, samples.data(), samples.size(),
+                                         8),
+            expected.size());
+  EXPECT_EQ(samples, expected);
+}
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 8000;
+
+/// The byte every untouched channel holds.
+constexpr u8 SENTINEL = 0xA5;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_gen_ctx ctx = {};
+
+/// Defines where samples are stored within each frame.
+struct layout {
+  /// The number of samples in one frame.
+  size_t stride;
+
+  /// The first channel stored to.
+  size_t channel_first;
+
+  /// The number of consecutive channels stored to.
+  size_t channels;
+};
+
+/// Prepares the generation context to generate a new message.
+void ctx_prepare() {
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, LIBSAME_GEN_ENGINE_DDS);
+}
+
+/// Generates a whole message as signed 16-bit samples.
+std::vector<s16> message_gen() {
+  ctx_prepare();
+
+  std::vector<s16> samples;
+  s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  size_t num;
+
+  while ((num = libsame_samples_gen_buf(&ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    samples.insert(samples.end(), buf, buf + num);
+  }
+  return samples;
+}
+
+/// Decodes one sample of an output sample format back to a signed 16-bit
+/// sample.
+s16 sample_decode(const enum libsame_sample_fmt fmt, const u8 *const data) {
+  switch (fmt) {
+    case LIBSAME_SAMPLE_FMT_S16LE:
+      return static_cast<s16>(data[0] | (data[1] << 8));
+
+    case LIBSAME_SAMPLE_FMT_S16BE:
+      return static_cast<s16>(data[1] | (data[0] << 8));
+
+    case LIBSAME_SAMPLE_FMT_S24LE:
+      return static_cast<s16>(data[1] | (data[2] << 8));
+
+    case LIBSAME_SAMPLE_FMT_S32LE:
+      return static_cast<s16>(data[2] | (data[3] << 8));
+
+    case LIBSAME_SAMPLE_FMT_F32: {
+      float sample;
+      std::memcpy(&sample, data, sizeof(sample));
+      return static_cast<s16>(sample * 32768.0F);
+    }
+
+    default:
+      ADD_FAILURE() << fmt;
+      return 0;
+  }
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every sample is stored to exactly the requested channels of
+/// its frame in every output sample format, and that every other channel is
+/// left untouched.
+TEST(libsame_samples_gen_strided, StoresToRequestedChannels) {
+  libsame_init();
+
+  const std::vector<s16> expected = message_gen();
+
+  for (int fmt = 0; fmt < LIBSAME_SAMPLE_FMT_NUM; ++fmt) {
+    const auto sample_fmt = static_cast<enum libsame_sample_fmt>(fmt);
+    const size_t size = libsame_sample_fmt_size_get(sample_fmt);
+
+    for (const layout &l : {layout{1, 0, 1}, layout{2, 1, 1}, layout{2, 0, 2},
+                            layout{8, 2, 3}, layout{8, 0, 8}}) {
+      SCOPED_TRACE(testing::Message() << fmt << ' ' << l.stride << ' '
+                                      << l.channel_first << ' ' << l.channels);
+      ctx_prepare();
+
+      const size_t frame_size = l.stride * size;
+      std::vector<u8> data(expected.size() * frame_size, SENTINEL);
+
+      size_t frames = 0;
+      size_t num;
+
+      // An odd number of frames per call exercises the scalar tail of every
+      // vectorized writer.
+      while ((num = libsame_samples_gen_strided(
+                  &ctx, sample_fmt,
+                  &data[(frames * frame_size) + (l.channel_first * size)],
+                  std::min<size_t>(1001, expected.size() - frames), l.stride,
+                  l.channels)) != 0) {
+        frames += num;
+      }
+      ASSERT_EQ(frames, expected.size());
+
+      for (size_t frame = 0; frame < frames; ++frame) {
+        for (size_t channel = 0; channel < l.stride; ++channel) {
+          const u8 *const sample =
+              &data[(frame * frame_size) + (channel * size)];
+
+          if ((channel >= l.channel_first) &&
+              (channel < (l.channel_first + l.channels))) {
+            ASSERT_EQ(sample_decode(sample_fmt, sample), expected[frame])
+                << frame << ' ' << channel;
+          } else {
+            for (size_t i = 0; i < size; ++i) {
+              ASSERT_EQ(sample[i], SENTINEL) << frame << ' ' << channel;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Verifies that a stride of one produces exactly the same output as
+/// libsame_samples_gen_fmt().
+TEST(libsame_samples_gen_strided, ContiguousMatchesSamplesGenFmt) {
+  constexpr size_t NUM = 50000;
+
+  std::vector<float> expected(NUM);
+  std::vector<float> samples(NUM);
+
+  ctx_prepare();
+  ASSERT_EQ(libsame_samples_gen_fmt(&ctx, LIBSAME_SAMPLE_FMT_F32,
+                                    expected.data(), NUM),
+            NUM);
+
+  ctx_prepare();
+  ASSERT_EQ(libsame_samples_gen_strided(&ctx, LIBSAME_SAMPLE_FMT_F32,
+                                        samples.data(), NUM, 1, 1),
+            NUM);
+
+  EXPECT_EQ(samples, expected);
+}
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 11025;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_gen_ctx ctx = {};
+
+/// Prepares the generation context to generate a new message.
+///
+/// @param engine The generation engine to use.
+/// @returns The offset of each sequence state within the message, followed by
+///          the number of samples in the message.
+std::vector<size_t> ctx_prepare(const enum libsame_gen_engine engine) {
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_ctx_gen_engine_set(&ctx, engine);
+
+  std::vector<size_t> offsets = {0};
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    offsets.push_back(offsets.back() + ctx.seq_samples_remaining[state]);
+  }
+  return offsets;
+}
+
+/// Generates the rest of the message.
+std::vector<s16> rest_gen() {
+  std::vector<s16> samples;
+  s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  size_t num;
+
+  while ((num = libsame_samples_gen_buf(&ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    samples.insert(samples.end(), buf, buf + num);
+  }
+  return samples;
+}
+
+/// Calculates the sample positions to seek to: the start of and a position
+/// within every sequence state, and the last sample of the message.
+std::vector<size_t> positions_get(const std::vector<size_t> &offsets) {
+  std::vector<size_t> positions;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    positions.push_back(offsets[state]);
+    positions.push_back(offsets[state] +
+                        (offsets[state + 1] - offsets[state]) * 5 / 7);
+  }
+  positions.push_back(offsets.back() - 1);
+  return positions;
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that generation engines keeping their phase in an integer
+/// accumulator, or not keeping one at all, produce exactly the same samples
+/// after seeking as when generating the message from the start.
+TEST(libsame_seek, ExactEnginesMatchFromStart) {
+  libsame_init();
+
+  for (const auto engine :
+       {LIBSAME_GEN_ENGINE_LIBC, LIBSAME_GEN_ENGINE_POLY,
+        LIBSAME_GEN_ENGINE_SIMD, LIBSAME_GEN_ENGINE_DDS,
+        LIBSAME_GEN_ENGINE_POLY_FIXED}) {
+    const std::vector<size_t> offsets = ctx_prepare(engine);
+    const std::vector<s16> expected = rest_gen();
+
+    ASSERT_EQ(expected.size(), offsets.back());
+
+    for (const size_t pos : positions_get(offsets)) {
+      ctx_prepare(engine);
+      libsame_seek(&ctx, pos);
+
+      const std::vector<s16> samples = rest_gen();
+
+      ASSERT_EQ(samples.size(), expected.size() - pos) << engine << ' ' << pos;
+      ASSERT_TRUE(std::equal(samples.begin(), samples.end(),
+                             expected.begin() + static_cast<ptrdiff_t>(pos)))
+          << engine << ' ' << pos;
+    }
+  }
+}
+
+/// Verifies that generation engines accumulating their phase in floating point
+/// stay close to the samples generated from the start after seeking. They
+/// differ by the rounding error generating from the start accumulates, which
+/// grows over the attention signal.
+TEST(libsame_seek, FloatEnginesStayClose) {
+  libsame_init();
+
+  for (const auto engine :
+       {LIBSAME_GEN_ENGINE_LUT, LIBSAME_GEN_ENGINE_ROTATOR}) {
+    const std::vector<size_t> offsets = ctx_prepare(engine);
+    const std::vector<s16> expected = rest_gen();
+
+    for (const size_t pos : positions_get(offsets)) {
+      ctx_prepare(engine);
+      libsame_seek(&ctx, pos);
+
+      const std::vector<s16> samples = rest_gen();
+
+      ASSERT_EQ(samples.size(), expected.size() - pos) << engine << ' ' << pos;
+
+      for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(samples[i], expected[pos + i], 128)
+            << engine << ' ' << pos << ' ' << i;
+      }
+    }
+  }
+}
+
+/// Verifies that seeking backwards after generating part of a message produces
+/// the same samples as seeking a fresh generation context.
+TEST(libsame_seek, SeekBackwards) {
+  const std::vector<size_t> offsets = ctx_prepare(LIBSAME_GEN_ENGINE_DDS);
+  const size_t pos = offsets[LIBSAME_SEQ_STATE_AFSK_HEADER_SECOND] + 1234;
+
+  libsame_seek(&ctx, pos);
+  const std::vector<s16> expected = rest_gen();
+
+  ctx_prepare(LIBSAME_GEN_ENGINE_DDS);
+  libsame_seek(&ctx, offsets[LIBSAME_SEQ_STATE_AFSK_EOM_FIRST] + 99);
+  rest_gen();
+  libsame_seek(&ctx, pos);
+
+  EXPECT_EQ(rest_gen(), expected);
+}
+
+/// Verifies that seeking to or past the end of the message finishes the
+/// sequence.
+TEST(libsame_seek, SeekPastEndFinishes) {
+  const std::vector<size_t> offsets = ctx_prepare(LIBSAME_GEN_ENGINE_DDS);
+
+  for (const size_t pos : {offsets.back(), offsets.back() + 1000}) {
+    libsame_seek(&ctx, pos);
+    EXPECT_EQ(ctx.seq_state, LIBSAME_SEQ_STATE_NUM);
+  }
+}
+
+/// Verifies that seeking with AFSK bit templates attached produces exactly the
+/// same samples as generating the message from the start with them.
+TEST(libsame_seek, TemplatesMatchFromStart) {
+  static struct libsame_afsk_templates templates = {};
+
+  libsame_init();
+
+  const std::vector<size_t> offsets = ctx_prepare(LIBSAME_GEN_ENGINE_DDS);
+  libsame_afsk_templates_init(&templates, &ctx);
+  libsame_ctx_afsk_templates_set(&ctx, &templates);
+
+  const std::vector<s16> expected = rest_gen();
+
+  for (const size_t pos : positions_get(offsets)) {
+    ctx_prepare(LIBSAME_GEN_ENGINE_DDS);
+    libsame_ctx_afsk_templates_set(&ctx, &templates);
+    libsame_seek(&ctx, pos);
+
+    const std::vector<s16> samples = rest_gen();
+
+    ASSERT_TRUE(std::equal(samples.begin(), samples.end(),
+                           expected.begin() + static_cast<ptrdiff_t>(pos)))
+        << pos;
+  }
+}
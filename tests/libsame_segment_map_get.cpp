@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the segments are in sequence order, contiguous, and add up to
+/// the total number of samples.
+TEST(libsame_segment_map_get, SegmentsAreContiguous) {
+  struct libsame_segment_map map;
+  libsame_segment_map_get(&map, &header, 44100);
+
+  size_t pos = 0;
+
+  for (size_t i = 0; i < LIBSAME_SEQ_STATE_NUM; ++i) {
+    EXPECT_EQ(map.segments[i].state, static_cast<enum libsame_seq_state>(i));
+    EXPECT_EQ(map.segments[i].start, pos);
+    EXPECT_GT(map.segments[i].num, 0);
+
+    pos += map.segments[i].num;
+  }
+  EXPECT_EQ(map.samples_num, pos);
+}
+
+/// Verifies that the segment lengths match what libsame_ctx_init() calculates.
+TEST(libsame_segment_map_get, MatchesCtxInit) {
+  static struct libsame_gen_ctx ctx = {};
+  struct libsame_segment_map map;
+
+  for (const unsigned int sample_rate : {8000U, 11025U, 44100U, 96000U}) {
+    libsame_segment_map_get(&map, &header, sample_rate);
+    libsame_ctx_init(&ctx, &header, sample_rate);
+
+    for (size_t i = 0; i < LIBSAME_SEQ_STATE_NUM; ++i) {
+      EXPECT_EQ(map.segments[i].num, ctx.seq_samples_remaining[i])
+          << sample_rate << ' ' << i;
+    }
+    EXPECT_EQ(map.segments[LIBSAME_SEQ_STATE_SILENCE_FIRST].num, sample_rate);
+    EXPECT_EQ(map.segments[LIBSAME_SEQ_STATE_ATTENTION_SIGNAL].num,
+              header.attn_sig_duration * sample_rate);
+  }
+}
+
+/// Verifies that the total number of samples is exactly the number of samples
+/// generated.
+TEST(libsame_segment_map_get, TotalMatchesGeneration) {
+  static struct libsame_gen_ctx ctx = {};
+  static s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  struct libsame_segment_map map;
+
+  libsame_init();
+  libsame_segment_map_get(&map, &header, 22050);
+  libsame_ctx_init(&ctx, &header, 22050);
+
+  size_t total = 0;
+  size_t num;
+
+  while ((num = libsame_samples_gen_buf(&ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    total += num;
+  }
+  EXPECT_EQ(map.samples_num, total);
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+#include "stream_fixture.h"
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the number of buffered samples follows both the producer and
+/// the consumer.
+TEST(libsame_stream_buffered, TracksProducerAndConsumer) {
+  stream_prepare();
+  std::vector<s16> dst(HIGH_WATER);
+
+  EXPECT_EQ(libsame_stream_buffered(&stream), 0);
+
+  libsame_stream_produce(&stream);
+  EXPECT_EQ(libsame_stream_buffered(&stream), HIGH_WATER);
+
+  libsame_stream_read(&stream, dst.data(), 100);
+  EXPECT_EQ(libsame_stream_buffered(&stream), HIGH_WATER - 100);
+
+  libsame_stream_read(&stream, dst.data(), dst.size());
+  EXPECT_EQ(libsame_stream_buffered(&stream), 0);
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+#include "stream_fixture.h"
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the ring buffer is filled to the high water mark, and only
+/// refilled once it drains below the low water mark.
+TEST(libsame_stream_produce, HonorsWaterMarks) {
+  stream_prepare();
+  std::vector<s16> dst(HIGH_WATER);
+
+  EXPECT_EQ(libsame_stream_produce(&stream), HIGH_WATER);
+  EXPECT_EQ(libsame_stream_produce(&stream), 0);
+
+  libsame_stream_read(&stream, dst.data(), HIGH_WATER - LOW_WATER);
+  EXPECT_EQ(libsame_stream_produce(&stream), 0);
+
+  libsame_stream_read(&stream, dst.data(), 1);
+  EXPECT_EQ(libsame_stream_produce(&stream), HIGH_WATER - LOW_WATER + 1);
+}
+
+/// Verifies that refills wrapping around the end of the ring buffer are
+/// generated into both ends of it.
+TEST(libsame_stream_produce, WrapsAround) {
+  stream_prepare();
+  std::vector<s16> expected(BUF_NUM * 4);
+  struct libsame_gen_ctx ref = ctx;
+
+  libsame_samples_gen_buf(&ref, expected.data(), expected.size());
+
+  std::vector<s16> samples;
+  std::vector<s16> dst(HIGH_WATER);
+
+  while (samples.size() < expected.size()) {
+    libsame_stream_produce(&stream);
+    const size_t num = libsame_stream_read(&stream, dst.data(), 500);
+    samples.insert(samples.end(), dst.begin(),
+                   dst.begin() + static_cast<ptrdiff_t>(num));
+  }
+  samples.resize(expected.size());
+  EXPECT_EQ(samples, expected);
+}
+
+/// Verifies that the producer stops once the end of the sequence is reached.
+TEST(libsame_stream_produce, Finishes) {
+  const size_t total = stream_prepare().size();
+  std::vector<s16> dst(HIGH_WATER);
+  size_t produced = 0;
+  size_t num;
+
+  do {
+    num = libsame_stream_produce(&stream);
+    produced += num;
+    libsame_stream_read(&stream, dst.data(), dst.size());
+  } while (!libsame_stream_done(&stream));
+
+  EXPECT_EQ(produced, total);
+  EXPECT_EQ(libsame_stream_produce(&stream), 0);
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+#include "stream_fixture.h"
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that a consumer reading concurrently with a producer receives
+/// exactly the samples libsame_samples_gen_buf() generates.
+TEST(libsame_stream_read, MatchesSamplesGenBufConcurrently) {
+  const std::vector<s16> expected = stream_prepare();
+
+  std::thread producer([] {
+    while (!libsame_stream_done(&stream)) {
+      if (libsame_stream_produce(&stream) == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<s16> samples;
+  std::vector<s16> dst(100);
+
+  while (!libsame_stream_done(&stream)) {
+    const size_t num = libsame_stream_read(&stream, dst.data(), dst.size());
+    samples.insert(samples.end(), dst.begin(),
+                   dst.begin() + static_cast<ptrdiff_t>(num));
+  }
+  producer.join();
+
+  EXPECT_EQ(samples, expected);
+}
+
+/// Verifies that reading more samples than are buffered fills the rest with
+/// silence and counts an underrun.
+TEST(libsame_stream_read, FillsUnderrunWithSilence) {
+  const std::vector<s16> expected = stream_prepare();
+  std::vector<s16> dst(HIGH_WATER + 100, 1);
+
+  libsame_stream_produce(&stream);
+
+  EXPECT_EQ(libsame_stream_read(&stream, dst.data(), dst.size()), HIGH_WATER);
+  EXPECT_TRUE(std::equal(dst.begin(), dst.begin() + HIGH_WATER,
+                         expected.begin()));
+  EXPECT_TRUE(std::all_of(dst.begin() + HIGH_WATER, dst.end(),
+                          [](const s16 sample) { return sample == 0; }));
+  EXPECT_EQ(stream.underruns, 1);
+}
+
+/// Verifies that running out at the end of the sequence is not an underrun,
+/// and that the stream is done only once every sample was read.
+TEST(libsame_stream_read, FinishesWithoutUnderrun) {
+  const std::vector<s16> expected = stream_prepare();
+  std::vector<s16> dst(LOW_WATER);
+  size_t read = 0;
+
+  while (read + dst.size() <= expected.size()) {
+    libsame_stream_produce(&stream);
+    read += libsame_stream_read(&stream, dst.data(), dst.size());
+  }
+  libsame_stream_produce(&stream);
+
+  EXPECT_FALSE(libsame_stream_done(&stream));
+  EXPECT_EQ(libsame_stream_read(&stream, dst.data(), dst.size()),
+            expected.size() - read);
+  EXPECT_TRUE(libsame_stream_done(&stream));
+  EXPECT_EQ(stream.underruns, 0);
+}
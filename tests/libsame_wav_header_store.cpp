@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+/// Loads a 16-bit little-endian value.
+unsigned int le16_load(const u8 *const src) { return src[0] | (src[1] << 8); }
+
+/// Loads a 32-bit little-endian value.
+unsigned int le32_load(const u8 *const src) {
+  return le16_load(&src[0]) | (le16_load(&src[2]) << 16);
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that every field of the header is stored in little-endian byte
+/// order, at any alignment.
+TEST(libsame_wav_header_store, Fields) {
+  for (const size_t offset : {0, 1, 2, 3}) {
+    SCOPED_TRACE(offset);
+
+    u8 buf[LIBSAME_WAV_HEADER_SIZE + 4];
+    u8 *const file = &buf[offset];
+
+    libsame_wav_header_store(file, 48000, 100000);
+
+    EXPECT_EQ(std::memcmp(&file[0], "RIFF", 4), 0);
+    EXPECT_EQ(le32_load(&file[4]), 200000U + LIBSAME_WAV_HEADER_SIZE - 8);
+    EXPECT_EQ(std::memcmp(&file[8], "WAVEfmt ", 8), 0);
+    EXPECT_EQ(le32_load(&file[16]), 16U);
+    EXPECT_EQ(le16_load(&file[20]), 1U);
+    EXPECT_EQ(le16_load(&file[22]), 1U);
+    EXPECT_EQ(le32_load(&file[24]), 48000U);
+    EXPECT_EQ(le32_load(&file[28]), 96000U);
+    EXPECT_EQ(le16_load(&file[32]), 2U);
+    EXPECT_EQ(le16_load(&file[34]), 16U);
+    EXPECT_EQ(std::memcmp(&file[36], "data", 4), 0);
+    EXPECT_EQ(le32_load(&file[40]), 200000U);
+  }
+}
+
+/// Verifies that the header is the one libsame_wav_render() stores.
+TEST(libsame_wav_header_store, MatchesRender) {
+  static struct libsame_gen_ctx ctx;
+
+  libsame_init();
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, 22050);
+
+  const size_t size = libsame_wav_size_get(&ctx);
+  const size_t samples_num = (size - LIBSAME_WAV_HEADER_SIZE) / 2;
+  std::vector<u8> file(size);
+  u8 stored[LIBSAME_WAV_HEADER_SIZE];
+
+  libsame_wav_header_store(stored, 22050, samples_num);
+  libsame_wav_render(&ctx, file.data(), file.size());
+
+  EXPECT_EQ(std::memcmp(stored, file.data(), sizeof(stored)), 0);
+}
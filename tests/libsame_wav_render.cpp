@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+/// The sample rate the messages are rendered at.
+constexpr unsigned int SAMPLE_RATE = 11025;
+
+/// Loads a 16-bit little-endian value.
+unsigned int le16_load(const u8 *const src) { return src[0] | (src[1] << 8); }
+
+/// Loads a 32-bit little-endian value.
+unsigned int le32_load(const u8 *const src) {
+  return le16_load(&src[0]) | (le16_load(&src[2]) << 16);
+}
+
+/// Renders the rest of a message with libsame_samples_gen_buf().
+std::vector<s16> buf_render(struct libsame_gen_ctx *const ctx) {
+  std::vector<s16> samples;
+  s16 buf[LIBSAME_SAMPLES_NUM_MAX];
+  size_t num;
+
+  while ((num = libsame_samples_gen_buf(ctx, buf, LIBSAME_SAMPLES_NUM_MAX)) !=
+         0) {
+    samples.insert(samples.end(), buf, buf + num);
+  }
+  return samples;
+}
+
+/// Checks a rendered WAV file against the samples it should hold.
+void wav_check(const u8 *const file, const std::vector<s16> &expected) {
+  const size_t data_size = expected.size() * 2;
+
+  EXPECT_EQ(std::memcmp(&file[0], "RIFF", 4), 0);
+  EXPECT_EQ(le32_load(&file[4]), data_size + LIBSAME_WAV_HEADER_SIZE - 8);
+  EXPECT_EQ(std::memcmp(&file[8], "WAVEfmt ", 8), 0);
+  EXPECT_EQ(le32_load(&file[16]), 16U);
+  EXPECT_EQ(le16_load(&file[20]), 1U);
+  EXPECT_EQ(le16_load(&file[22]), 1U);
+  EXPECT_EQ(le32_load(&file[24]), SAMPLE_RATE);
+  EXPECT_EQ(le32_load(&file[28]), SAMPLE_RATE * 2);
+  EXPECT_EQ(le16_load(&file[32]), 2U);
+  EXPECT_EQ(le16_load(&file[34]), 16U);
+  EXPECT_EQ(std::memcmp(&file[36], "data", 4), 0);
+  EXPECT_EQ(le32_load(&file[40]), data_size);
+
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(static_cast<s16>(
+                  le16_load(&file[LIBSAME_WAV_HEADER_SIZE + (i * 2)])),
+              expected[i])
+        << i;
+  }
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that a whole message is rendered as a WAV file holding exactly the
+/// samples libsame_samples_gen_buf() generates, at every alignment.
+TEST(libsame_wav_render, WholeMessage) {
+  static struct libsame_gen_ctx ctx;
+
+  libsame_init();
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+
+  const std::vector<s16> expected = buf_render(&ctx);
+
+  for (const size_t offset : {0, 1, 2, 3}) {
+    SCOPED_TRACE(offset);
+
+    std::memset(&ctx, 0, sizeof(ctx));
+    libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+
+    const size_t size = libsame_wav_size_get(&ctx);
+    std::vector<u8> file(offset + size + 1, 0xAA);
+
+    EXPECT_EQ(libsame_wav_render(&ctx, &file[offset], size), expected.size());
+    wav_check(&file[offset], expected);
+
+    // Nothing past the end of the file is touched.
+    EXPECT_EQ(file[offset + size], 0xAA);
+  }
+}
+
+/// Verifies that the rest of a message is rendered from wherever generation
+/// left off.
+TEST(libsame_wav_render, Remaining) {
+  static struct libsame_gen_ctx ctx;
+  s16 buf[1000];
+
+  libsame_init();
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  libsame_samples_gen_buf(&ctx, buf, 1000);
+
+  struct libsame_gen_ctx *const copy = new struct libsame_gen_ctx(ctx);
+  const std::vector<s16> expected = buf_render(copy);
+  delete copy;
+
+  std::vector<u8> file(libsame_wav_size_get(&ctx));
+
+  EXPECT_EQ(libsame_wav_render(&ctx, file.data(), file.size()),
+            expected.size());
+  wav_check(file.data(), expected);
+}
+
+/// Verifies that a finished message is rendered as an empty WAV file.
+TEST(libsame_wav_render, Finished) {
+  static struct libsame_gen_ctx ctx;
+
+  libsame_init();
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+  buf_render(&ctx);
+
+  u8 file[LIBSAME_WAV_HEADER_SIZE];
+
+  ASSERT_EQ(libsame_wav_size_get(&ctx), sizeof(file));
+  EXPECT_EQ(libsame_wav_render(&ctx, file, sizeof(file)), 0);
+  wav_check(file, {});
+}
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "libsame/libsame.h"
+
+namespace {
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that the size of a whole message is the header plus two bytes per
+/// sample of the segment map.
+TEST(libsame_wav_size_get, WholeMessage) {
+  static struct libsame_gen_ctx ctx;
+  struct libsame_segment_map map;
+
+  for (const unsigned int sample_rate : {8000U, 11025U, 44100U, 96000U}) {
+    std::memset(&ctx, 0, sizeof(ctx));
+    libsame_ctx_init(&ctx, &header, sample_rate);
+    libsame_segment_map_get(&map, &header, sample_rate);
+
+    EXPECT_EQ(libsame_wav_size_get(&ctx),
+              LIBSAME_WAV_HEADER_SIZE + (map.samples_num * 2))
+        << sample_rate;
+  }
+}
+
+/// Verifies that only the samples remaining count once generation has started,
+/// and that a finished message is only a header.
+TEST(libsame_wav_size_get, Remaining) {
+  static struct libsame_gen_ctx ctx;
+  struct libsame_segment_map map;
+
+  libsame_init();
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, 22050);
+  libsame_segment_map_get(&map, &header, 22050);
+
+  for (const size_t pos : {size_t{1}, size_t{12345}, map.samples_num / 2,
+                           map.samples_num - 1, map.samples_num}) {
+    libsame_seek(&ctx, pos);
+    EXPECT_EQ(libsame_wav_size_get(&ctx),
+              LIBSAME_WAV_HEADER_SIZE + ((map.samples_num - pos) * 2))
+        << pos;
+  }
+}
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "header_parse.h"
+#include "libsame/libsame.h"
+
+namespace {
+/// Parses a CSV line into a zeroed header.
+const char *csv_parse(struct libsame_header *const header,
+                      const std::string &line) {
+  std::memset(header, 0, sizeof(*header));
+  return header_parse_csv(header, line.c_str());
+}
+
+/// Parses a JSON-lines line into a zeroed header.
+const char *jsonl_parse(struct libsame_header *const header,
+                        const std::string &line) {
+  std::memset(header, 0, sizeof(*header));
+  return header_parse_jsonl(header, line.c_str());
+}
+
+/// Builds a list of the specified number of dash separated location codes.
+std::string location_codes_build(const size_t num) {
+  std::string codes;
+
+  for (size_t i = 0; i < num; ++i) {
+    codes += (i == 0) ? "" : "-";
+    codes += std::to_string(100000 + i);
+  }
+  return codes;
+}
+
+/// Checks that a header holds the fields of the valid lines of these tests.
+void header_check(const struct libsame_header &header) {
+  EXPECT_STREQ(header.originator_code, "WXR");
+  EXPECT_STREQ(header.event_code, "TOR");
+  EXPECT_STREQ(header.location_codes[0], "012345");
+  EXPECT_STREQ(header.location_codes[1], "056789");
+  EXPECT_STREQ(header.location_codes[2], LIBSAME_LOCATION_CODE_END_MARKER);
+  EXPECT_STREQ(header.valid_time_period, "0030");
+  EXPECT_STREQ(header.originator_time, "1231200");
+  EXPECT_STREQ(header.callsign, "KEAX    ");
+  EXPECT_EQ(header.attn_sig_duration, 9);
+}
+};  // namespace
+
+#ifndef NDEBUG
+void *libsame_dbg_userdata_ = nullptr;
+
+extern "C" [[noreturn]] void libsame_assert_failed(const char *const,
+                                                   const char *const, const int,
+                                                   void *) {
+  std::abort();
+}
+#endif  // NDEBUG
+
+/// Verifies that a valid CSV line is parsed into every field, with the
+/// callsign padded with spaces.
+TEST(same_render_header_parse, CsvValid) {
+  struct libsame_header header;
+
+  ASSERT_EQ(csv_parse(&header, "WXR,TOR,012345-056789,0030,1231200,KEAX,9"),
+            nullptr);
+  header_check(header);
+}
+
+/// Verifies that a CSV line holding every location code a header can have is
+/// parsed, without an end marker.
+TEST(same_render_header_parse, CsvMostLocationCodes) {
+  struct libsame_header header;
+
+  ASSERT_EQ(csv_parse(&header, "WXR,TOR," +
+                                   location_codes_build(
+                                       LIBSAME_LOCATION_CODES_NUM_MAX) +
+                                   ",0030,1231200,KEAX,9"),
+            nullptr);
+  EXPECT_STREQ(header.location_codes[LIBSAME_LOCATION_CODES_NUM_MAX - 1],
+               "100030");
+}
+
+/// Verifies that malformed CSV lines are rejected.
+TEST(same_render_header_parse, CsvMalformed) {
+  const std::string lines[] = {
+      "",
+      "WXR,TOR,012345,0030,1231200,KEAX",
+      "WXR,TOR,012345,0030,1231200,KEAX,9,",
+      "WX,TOR,012345,0030,1231200,KEAX,9",
+      "WXR,TORR,012345,0030,1231200,KEAX,9",
+      "WXR,TOR,,0030,1231200,KEAX,9",
+      "WXR,TOR,01234,0030,1231200,KEAX,9",
+      "WXR,TOR,012345--056789,0030,1231200,KEAX,9",
+      "WXR,TOR,012345-,0030,1231200,KEAX,9",
+      "WXR,TOR,-012345,0030,1231200,KEAX,9",
+      "WXR,TOR,01234A,0030,1231200,KEAX,9",
+      "W1R,TOR,012345,0030,1231200,KEAX,9",
+      "WXR,T0R,012345,0030,1231200,KEAX,9",
+      "wxr,TOR,012345,0030,1231200,KEAX,9",
+      "WXR,TOR," + location_codes_build(LIBSAME_LOCATION_CODES_NUM_MAX + 1) +
+          ",0030,1231200,KEAX,9",
+      "WXR,TOR,012345,030,1231200,KEAX,9",
+      "WXR,TOR,012345,0030,123120,KEAX,9",
+      "WXR,TOR,012345,00+0,1231200,KEAX,9",
+      "WXR,TOR,012345,0030,12312O0,KEAX,9",
+      "WXR,TOR,012345,0030,1231200,,9",
+      "WXR,TOR,012345,0030,1231200,KEAX/NWS1,9",
+      "WXR,TOR,012345,0030,1231200,KEWX-NWS,9",
+      "WXR,TOR,012345,0030,1231200,KEWX+,9",
+      "WXR,TOR,012345,0030,1231200,KEAX,",
+      "WXR,TOR,012345,0030,1231200,KEAX,7",
+      "WXR,TOR,012345,0030,1231200,KEAX,26",
+      "WXR,TOR,012345,0030,1231200,KEAX,9s",
+      "WXR,TOR,012345,0030,1231200,KEAX,99999999999"};
+
+  for (const auto &line : lines) {
+    struct libsame_header header;
+    EXPECT_NE(csv_parse(&header, line), nullptr) << line;
+  }
+}
+
+/// Verifies that only a line naming the columns is taken as one.
+TEST(same_render_header_parse, CsvColumns) {
+  EXPECT_TRUE(header_parse_csv_columns(
+      "originator_code,event_code,location_codes,valid_time_period,"
+      "originator_time,callsign,attn_sig_duration"));
+  EXPECT_FALSE(
+      header_parse_csv_columns("WXR,TOR,012345-056789,0030,1231200,KEAX,9"));
+}
+
+/// Verifies that a valid JSON-lines line is parsed into every field, in any
+/// order and with any whitespace between tokens.
+TEST(same_render_header_parse, JsonlValid) {
+  struct libsame_header header;
+
+  ASSERT_EQ(jsonl_parse(&header,
+                        "{\"originator_code\":\"WXR\",\"event_code\":\"TOR\","
+                        "\"location_codes\":[\"012345\",\"056789\"],"
+                        "\"valid_time_period\":\"0030\","
+                        "\"originator_time\":\"1231200\","
+                        "\"callsign\":\"KEAX\",\"attn_sig_duration\":9}"),
+            nullptr);
+  header_check(header);
+
+  ASSERT_EQ(jsonl_parse(&header,
+                        "\t{ \"attn_sig_duration\" : 9 ,\r\"callsign\" : "
+                        "\"KEAX\", \"originator_time\" : \"1231200\", "
+                        "\"valid_time_period\" : \"0030\", "
+                        "\"location_codes\" : [ \"012345\" , \"056789\" ], "
+                        "\"event_code\" : \"TOR\", "
+                        "\"originator_code\" : \"WXR\" } "),
+            nullptr);
+  header_check(header);
+}
+
+/// Verifies that escaped characters in JSON strings are unescaped.
+TEST(same_render_header_parse, JsonlEscapes) {
+  struct libsame_header header;
+
+  ASSERT_EQ(jsonl_parse(&header,
+                        "{\"originator_code\":\"WXR\",\"event_code\":\"TOR\","
+                        "\"location_codes\":[\"012345\"],"
+                        "\"valid_time_period\":\"0030\","
+                        "\"originator_time\":\"1231200\","
+                        "\"callsign\":\"KEAX\\/NWS\",\"attn_sig_duration\":9}"),
+            nullptr);
+  EXPECT_STREQ(header.callsign, "KEAX/NWS");
+}
+
+/// Verifies that malformed JSON-lines lines are rejected.
+TEST(same_render_header_parse, JsonlMalformed) {
+  const std::string fields =
+      "\"event_code\":\"TOR\",\"location_codes\":[\"012345\"],"
+      "\"valid_time_period\":\"0030\",\"originator_time\":\"1231200\","
+      "\"callsign\":\"KEAX\",\"attn_sig_duration\":9";
+
+  const std::string lines[] = {
+      "",
+      "[]",
+      "{" + fields + "}",
+      "{\"originator_code\":\"WXR\"," + fields,
+      "{\"originator_code\":\"WXR\"," + fields + "} x",
+      "{\"originator_code\":\"WXR\"," + fields + ",\"extra\":\"1\"}",
+      "{\"originator_code\":\"WXR\" " + fields + "}",
+      "{\"originator_code\" \"WXR\"," + fields + "}",
+      "{\"originator_code\":\"WXR," + fields + "}",
+      "{\"originator_code\":\"W\\nR\"," + fields + "}",
+      "{\"originator_code\":\"W\\u0058R\"," + fields + "}",
+      "{\"originator_code\":\"WXRWXRWXRWXRWXRWXRWXRWXRWXRWXRWXRWXR\"," +
+          fields + "}",
+      "{\"originator_code\":WXR," + fields + "}",
+      "{\"originator_code\":\"WXR\",\"location_codes\":\"012345\"," + fields +
+          "}",
+      "{\"originator_code\":\"WXR\",\"location_codes\":[\"012345\" "
+      "\"056789\"]," +
+          fields + "}",
+      "{\"originator_code\":\"WXR\",\"attn_sig_duration\":\"9\"," + fields +
+          "}",
+      "{\"originator_code\":\"WXR\",\"location_codes\":[\"012345\",]," +
+          fields + "}",
+      "{\"originator_code\":\"WXR\",\"location_codes\":[\"\"]," + fields +
+          "}",
+      "{\"originator_code\":\"WXR\"," + fields + ",}",
+      "{\"originator_code\":\"WXR\"," + fields + " , }",
+      "{\"originator_code\":\"W-R\"," + fields + "}"};
+
+  for (const auto &line : lines) {
+    struct libsame_header header;
+    EXPECT_NE(jsonl_parse(&header, line), nullptr) << line;
+  }
+}
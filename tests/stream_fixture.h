@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file stream_fixture.h
+/// Defines the stream, generation context and message shared by the
+/// libsame_stream_* tests, along with the helper that prepares them.
+
+#ifndef LIBSAME_TESTS_STREAM_FIXTURE_H
+#define LIBSAME_TESTS_STREAM_FIXTURE_H
+
+#include <cstring>
+#include <vector>
+
+#include "libsame/libsame.h"
+
+namespace {
+constexpr unsigned int SAMPLE_RATE = 11025;
+
+/// The number of samples the ring buffer holds.
+constexpr size_t BUF_NUM = 1024;
+
+constexpr size_t LOW_WATER = 256;
+constexpr size_t HIGH_WATER = 768;
+
+constexpr const struct libsame_header header = {
+    .location_codes = {"101010", "010101", LIBSAME_LOCATION_CODE_END_MARKER},
+    .valid_time_period = "1000",
+    .originator_code = "GOD",
+    .event_code = "GOG",
+    .callsign = "HEATISON",
+    .originator_time = "1717777",
+    .attn_sig_duration = 8};
+
+struct libsame_gen_ctx ctx = {};
+struct libsame_stream stream = {};
+s16 buf[BUF_NUM];
+
+/// Prepares a stream to stream a new message.
+///
+/// @returns The whole message, as generated by libsame_samples_gen_buf().
+std::vector<s16> stream_prepare() {
+  std::memset(&ctx, 0, sizeof(ctx));
+  libsame_ctx_init(&ctx, &header, SAMPLE_RATE);
+
+  size_t total = 0;
+
+  for (size_t state = 0; state < LIBSAME_SEQ_STATE_NUM; ++state) {
+    total += ctx.seq_samples_remaining[state];
+  }
+
+  struct libsame_gen_ctx ref = ctx;
+  std::vector<s16> expected(total);
+
+  libsame_samples_gen_buf(&ref, expected.data(), expected.size());
+  libsame_stream_init(&stream, &ctx, buf, BUF_NUM, LOW_WATER, HIGH_WATER);
+  return expected;
+}
+};  // namespace
+
+#endif  // LIBSAME_TESTS_STREAM_FIXTURE_H
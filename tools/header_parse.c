@@ -0,0 +1,401 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "header_parse.h"
+
+#include <string.h>
+
+// The fields of a header, in the order of the CSV columns.
+enum field {
+  FIELD_ORIGINATOR_CODE,
+  FIELD_EVENT_CODE,
+  FIELD_LOCATION_CODES,
+  FIELD_VALID_TIME_PERIOD,
+  FIELD_ORIGINATOR_TIME,
+  FIELD_CALLSIGN,
+  FIELD_ATTN_SIG_DURATION,
+  FIELD_NUM
+};
+
+// The names of the fields, as used by the CSV column names and JSON keys.
+static const char *const FIELD_NAMES[FIELD_NUM] = {
+    [FIELD_ORIGINATOR_CODE] = "originator_code",
+    [FIELD_EVENT_CODE] = "event_code",
+    [FIELD_LOCATION_CODES] = "location_codes",
+    [FIELD_VALID_TIME_PERIOD] = "valid_time_period",
+    [FIELD_ORIGINATOR_TIME] = "originator_time",
+    [FIELD_CALLSIGN] = "callsign",
+    [FIELD_ATTN_SIG_DURATION] = "attn_sig_duration"};
+
+// Determines whether every character of a field is a digit.
+static bool digits_are(const char *const value, const size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    if ((value[i] < '0') || (value[i] > '9')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Determines whether every character of a field is a capital letter.
+static bool letters_are(const char *const value, const size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    if ((value[i] < 'A') || (value[i] > 'Z')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Stores a field of a header.
+//
+// Every field is fixed length, except the callsign, which is padded with
+// spaces up to its length as the standard requires. Fields are separated by
+// '-' and '+' in the transmitted header, so neither may appear in one.
+//
+// @returns An error message, or NULL on success.
+static const char *field_set(struct libsame_header *const header,
+                             const enum field field, const char *const value,
+                             const size_t len) {
+  char *dst;
+  size_t dst_len;
+  bool valid;
+  const char *invalid_err;
+
+  switch (field) {
+    case FIELD_ORIGINATOR_CODE:
+      dst = header->originator_code;
+      dst_len = LIBSAME_ORIGINATOR_CODE_LEN;
+      valid = letters_are(value, len);
+      invalid_err = "originator_code must be capital letters";
+      break;
+
+    case FIELD_EVENT_CODE:
+      dst = header->event_code;
+      dst_len = LIBSAME_EVENT_CODE_LEN;
+      valid = letters_are(value, len);
+      invalid_err = "event_code must be capital letters";
+      break;
+
+    case FIELD_VALID_TIME_PERIOD:
+      dst = header->valid_time_period;
+      dst_len = LIBSAME_VALID_TIME_PERIOD_LEN;
+      valid = digits_are(value, len);
+      invalid_err = "valid_time_period must be digits";
+      break;
+
+    case FIELD_ORIGINATOR_TIME:
+      dst = header->originator_time;
+      dst_len = LIBSAME_ORIGINATOR_TIME_LEN;
+      valid = digits_are(value, len);
+      invalid_err = "originator_time must be digits";
+      break;
+
+    case FIELD_CALLSIGN:
+      if ((len == 0) || (len > LIBSAME_CALLSIGN_LEN)) {
+        return "callsign must be 1 to 8 characters";
+      }
+
+      for (size_t i = 0; i < len; ++i) {
+        if ((value[i] < ' ') || (value[i] > '~') || (value[i] == '-') ||
+            (value[i] == '+')) {
+          return "callsign must be printable and hold no '-' or '+'";
+        }
+      }
+      memset(header->callsign, ' ', LIBSAME_CALLSIGN_LEN);
+      memcpy(header->callsign, value, len);
+      header->callsign[LIBSAME_CALLSIGN_LEN] = '\0';
+      return NULL;
+
+    case FIELD_ATTN_SIG_DURATION: {
+      uint min;
+      uint max;
+      uint duration = 0;
+
+      libsame_attn_sig_durations_get(&min, &max);
+
+      for (size_t i = 0; i < len; ++i) {
+        if ((value[i] < '0') || (value[i] > '9') || (duration > max)) {
+          return "attn_sig_duration must be a whole number of seconds";
+        }
+        duration = (duration * 10) + (uint)(value[i] - '0');
+      }
+
+      if ((len == 0) || (duration < min) || (duration > max)) {
+        return "attn_sig_duration is out of range";
+      }
+      header->attn_sig_duration = duration;
+      return NULL;
+    }
+
+    case FIELD_LOCATION_CODES:
+    case FIELD_NUM:
+    default:
+      return "unknown field";
+  }
+
+  if (len != dst_len) {
+    return "field has the wrong length";
+  }
+
+  if (!valid) {
+    return invalid_err;
+  }
+  memcpy(dst, value, len);
+  dst[len] = '\0';
+
+  return NULL;
+}
+
+// Appends a location code to a header.
+//
+// @param num The number of location codes the header has so far.
+// @returns An error message, or NULL on success.
+static const char *location_code_add(struct libsame_header *const header,
+                                     size_t *const num,
+                                     const char *const value,
+                                     const size_t len) {
+  if (*num >= LIBSAME_LOCATION_CODES_NUM_MAX) {
+    return "too many location codes";
+  }
+
+  if ((len != LIBSAME_LOCATION_CODE_LEN) || !digits_are(value, len)) {
+    return "location codes must be 6 digits";
+  }
+
+  memcpy(header->location_codes[*num], value, len);
+  header->location_codes[*num][len] = '\0';
+  (*num)++;
+
+  if (*num < LIBSAME_LOCATION_CODES_NUM_MAX) {
+    strcpy(header->location_codes[*num], LIBSAME_LOCATION_CODE_END_MARKER);
+  }
+  return NULL;
+}
+
+const char *header_parse_csv(struct libsame_header *const header,
+                             const char *line) {
+  size_t locations_num = 0;
+
+  for (size_t field = 0; field < FIELD_NUM; ++field) {
+    const char *const end = line + strcspn(line, ",");
+    const size_t len = (size_t)(end - line);
+
+    if ((*end == '\0') != (field == (FIELD_NUM - 1))) {
+      return "expected 7 comma separated fields";
+    }
+
+    if (field == FIELD_LOCATION_CODES) {
+      if (len == 0) {
+        return "at least one location code is required";
+      }
+
+      // Every dash must be followed by another location code.
+      for (const char *code = line;;) {
+        const char *const code_end = code + strcspn(code, "-,");
+        const char *const err = location_code_add(
+            header, &locations_num, code, (size_t)(code_end - code));
+
+        if (err != NULL) {
+          return err;
+        }
+
+        if (*code_end != '-') {
+          break;
+        }
+        code = code_end + 1;
+      }
+    } else {
+      const char *const err = field_set(header, (enum field)field, line, len);
+
+      if (err != NULL) {
+        return err;
+      }
+    }
+    line = end + 1;
+  }
+  return NULL;
+}
+
+bool header_parse_csv_columns(const char *const line) {
+  return strncmp(line, FIELD_NAMES[0], strlen(FIELD_NAMES[0])) == 0;
+}
+
+// Skips JSON whitespace.
+static const char *json_ws_skip(const char *p) {
+  while ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n')) {
+    p++;
+  }
+  return p;
+}
+
+// Parses a JSON string into a buffer. Only the escapes a header can need are
+// understood.
+//
+// @returns A pointer past the string, or NULL if it is malformed or too long.
+static const char *json_str_parse(const char *p, char *const buf,
+                                  const size_t buf_size, size_t *const len) {
+  if (*p++ != '"') {
+    return NULL;
+  }
+
+  *len = 0;
+
+  while (*p != '"') {
+    char c = *p++;
+
+    if (c == '\0') {
+      return NULL;
+    }
+
+    if (c == '\\') {
+      c = *p++;
+
+      if ((c != '"') && (c != '\\') && (c != '/')) {
+        return NULL;
+      }
+    }
+
+    if (*len >= buf_size) {
+      return NULL;
+    }
+    buf[(*len)++] = c;
+  }
+  return p + 1;
+}
+
+const char *header_parse_jsonl(struct libsame_header *const header,
+                               const char *p) {
+  // Fields are bounded by their lengths, so a small buffer holds any valid
+  // value and longer ones are rejected as malformed.
+  char key[32];
+  char value[32];
+  size_t key_len;
+  size_t value_len;
+  size_t locations_num = 0;
+  uint seen = 0;
+
+  p = json_ws_skip(p);
+
+  if (*p++ != '{') {
+    return "expected a JSON object";
+  }
+
+  for (p = json_ws_skip(p); *p != '}';) {
+    p = json_str_parse(p, key, sizeof(key) - 1, &key_len);
+
+    if (p == NULL) {
+      return "malformed key";
+    }
+    key[key_len] = '\0';
+
+    size_t field = 0;
+
+    while ((field < FIELD_NUM) && (strcmp(key, FIELD_NAMES[field]) != 0)) {
+      field++;
+    }
+
+    if (field == FIELD_NUM) {
+      return "unknown key";
+    }
+
+    p = json_ws_skip(p);
+
+    if (*p++ != ':') {
+      return "expected ':'";
+    }
+    p = json_ws_skip(p);
+
+    const char *err = NULL;
+
+    if (field == FIELD_LOCATION_CODES) {
+      if (*p++ != '[') {
+        return "location_codes must be an array";
+      }
+
+      for (p = json_ws_skip(p); *p != ']';) {
+        p = json_str_parse(p, value, sizeof(value), &value_len);
+
+        if (p == NULL) {
+          return "malformed location code";
+        }
+
+        err = location_code_add(header, &locations_num, value, value_len);
+
+        if (err != NULL) {
+          return err;
+        }
+
+        p = json_ws_skip(p);
+
+        if (*p == ',') {
+          p = json_ws_skip(p + 1);
+
+          if (*p == ']') {
+            return "trailing ',' in location_codes";
+          }
+        } else if (*p != ']') {
+          return "expected ',' or ']'";
+        }
+      }
+      p++;
+    } else if (field == FIELD_ATTN_SIG_DURATION) {
+      const size_t len = strspn(p, "0123456789");
+
+      err = field_set(header, (enum field)field, p, len);
+      p += len;
+    } else {
+      p = json_str_parse(p, value, sizeof(value), &value_len);
+
+      if (p == NULL) {
+        return "malformed value";
+      }
+      err = field_set(header, (enum field)field, value, value_len);
+    }
+
+    if (err != NULL) {
+      return err;
+    }
+    seen |= 1U << field;
+
+    p = json_ws_skip(p);
+
+    if (*p == ',') {
+      p = json_ws_skip(p + 1);
+
+      if (*p == '}') {
+        return "trailing ',' in the object";
+      }
+    } else if (*p != '}') {
+      return "expected ',' or '}'";
+    }
+  }
+
+  if (*json_ws_skip(p + 1) != '\0') {
+    return "trailing characters after the object";
+  }
+
+  if ((seen != ((1U << FIELD_NUM) - 1)) || (locations_num == 0)) {
+    return "every field is required";
+  }
+  return NULL;
+}
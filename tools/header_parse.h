@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The header parsers of same-render, which read the headers of SAME messages
+// from the lines of a CSV or JSON-lines file.
+//
+// Every parser fills in a zeroed header, and reports what is wrong with a
+// malformed line rather than where.
+
+#ifndef SAME_RENDER_HEADER_PARSE_H
+#define SAME_RENDER_HEADER_PARSE_H
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#include <stdbool.h>
+
+#include "libsame/libsame.h"
+
+// Parses a header from a CSV line, with the columns
+//
+//     originator_code,event_code,location_codes,valid_time_period,
+//     originator_time,callsign,attn_sig_duration
+//
+// where the location codes are separated by dashes.
+//
+// @returns An error message, or NULL on success.
+const char *header_parse_csv(struct libsame_header *header, const char *line);
+
+// Determines whether a CSV line names the columns rather than holding a
+// header.
+bool header_parse_csv_columns(const char *line);
+
+// Parses a header from a JSON-lines line: one object keyed by the member names
+// of struct libsame_header, with location_codes as an array of strings.
+//
+// @returns An error message, or NULL on success.
+const char *header_parse_jsonl(struct libsame_header *header, const char *p);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // SAME_RENDER_HEADER_PARSE_H
@@ -0,0 +1,683 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// O_DIRECT is a GNU extension.
+#define _GNU_SOURCE
+
+#include "pipeline.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+// Writes can be submitted through io_uring.
+#define PIPELINE_HAVE_URING
+#endif  // __has_include(<linux/io_uring.h>)
+#endif  // defined(__linux__) && defined(__has_include)
+
+// The number of files a pipeline can have open at once: one for every buffer
+// still being written out, and the one being written to.
+#define PIPELINE_FILES_NUM (PIPELINE_BUFS_NUM + 1)
+
+// A file a pipeline writes to.
+struct pipeline_file {
+  // The number of bytes submitted so far.
+  size_t size;
+
+  // Where to report a failure to.
+  bool *failed_out;
+
+  // The file descriptor, or -1 if the slot is free.
+  int fd;
+
+  // The number of writes in flight.
+  uint pending;
+
+  // Whether more bytes may still be appended.
+  bool open;
+
+  // Whether the file was opened with O_DIRECT.
+  bool direct;
+
+  // Whether writing the file failed.
+  bool failed;
+
+  // Pads the flags up to the alignment of the byte count.
+  u8 padding[sizeof(size_t) - (3 * sizeof(bool))];
+};
+
+// A buffer of a pipeline.
+struct pipeline_buf {
+  // The bytes of the buffer.
+  u8 *data;
+
+  // The number of bytes stored.
+  size_t len;
+
+  // The offset within the file the buffer is written to.
+  off_t offset;
+
+  // The number of bytes being written, including any padding O_DIRECT needed.
+  size_t write_len;
+
+  // The slot of the file the buffer is written to.
+  size_t file;
+
+  // Whether the buffer is being written out.
+  bool in_flight;
+
+  // Pads the flag up to the alignment of the byte counts.
+  u8 padding[sizeof(size_t) - sizeof(bool)];
+};
+
+#ifdef PIPELINE_HAVE_URING
+// An io_uring instance, set up without liburing.
+struct uring {
+  // The submission queue.
+  u32 *sq_head;
+  u32 *sq_tail;
+  u32 *sq_mask;
+  u32 *sq_array;
+  struct io_uring_sqe *sqes;
+
+  // The completion queue.
+  u32 *cq_head;
+  u32 *cq_tail;
+  u32 *cq_mask;
+  struct io_uring_cqe *cqes;
+
+  // The mappings of the queues.
+  void *sq_map;
+  size_t sq_map_size;
+  void *cq_map;
+  size_t cq_map_size;
+  size_t sqes_size;
+
+  // The file descriptor of the ring, or -1 if there is none.
+  int fd;
+
+  // Whether the buffers of the pipeline are registered with the ring.
+  bool fixed;
+
+  // Pads the flag up to the alignment of the file descriptor.
+  u8 padding[sizeof(int) - sizeof(bool)];
+};
+#endif  // PIPELINE_HAVE_URING
+
+struct pipeline {
+#ifdef PIPELINE_HAVE_URING
+  // The ring writes are submitted through.
+  struct uring ring;
+#endif  // PIPELINE_HAVE_URING
+
+  // The buffers, used in turn.
+  struct pipeline_buf bufs[PIPELINE_BUFS_NUM];
+
+  // The files being written.
+  struct pipeline_file files[PIPELINE_FILES_NUM];
+
+  // The index of the buffer being filled.
+  size_t cur;
+
+  // The slot of the file being written to, or PIPELINE_FILES_NUM if none.
+  size_t file;
+
+  // The backend the buffers are written out with.
+  enum pipeline_backend backend;
+
+  // Whether files are opened with O_DIRECT.
+  bool direct;
+
+  // Pads the flag up to the alignment of the backend.
+  u8 padding[sizeof(enum pipeline_backend) - sizeof(bool)];
+};
+
+// Writes a whole span of bytes at an offset, despite short writes.
+//
+// @returns 0 on success, or a negated error number.
+static int pwrite_all(const int fd, const u8 *src, size_t size, off_t offset) {
+  while (size != 0) {
+    const ssize_t written = pwrite(fd, src, size, offset);
+
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -errno;
+    }
+
+    if (written == 0) {
+      return -EIO;
+    }
+
+    src += written;
+    size -= (size_t)written;
+    offset += written;
+  }
+  return 0;
+}
+
+// Closes a file once it was finished and its last write completed.
+static void file_finish(struct pipeline_file *const file) {
+  if (file->open || (file->pending != 0) || (file->fd == -1)) {
+    return;
+  }
+
+  // O_DIRECT writes were padded to the alignment; trim the padding off.
+  if (file->direct && (ftruncate(file->fd, (off_t)file->size) != 0)) {
+    file->failed = true;
+  }
+
+  if (close(file->fd) != 0) {
+    file->failed = true;
+  }
+
+  if (file->failed) {
+    *file->failed_out = true;
+  }
+  file->fd = -1;
+}
+
+// Handles the completion of the write of a buffer.
+//
+// @param res The number of bytes written, or a negated error number.
+static void buf_complete(struct pipeline *const pipeline, const size_t index,
+                         int res) {
+  struct pipeline_buf *const buf = &pipeline->bufs[index];
+  struct pipeline_file *const file = &pipeline->files[buf->file];
+
+  // Regular files only write short on errors such as a full disk; retrying
+  // the rest reports the error.
+  if ((res >= 0) && ((size_t)res < buf->write_len)) {
+    res = pwrite_all(file->fd, &buf->data[res], buf->write_len - (size_t)res,
+                     buf->offset + res);
+  }
+
+  if (res < 0) {
+    file->failed = true;
+  }
+
+  buf->in_flight = false;
+  file->pending--;
+  file_finish(file);
+}
+
+#ifdef PIPELINE_HAVE_URING
+// Enters the ring, to submit and/or wait for completions.
+static int uring_enter(const int fd, const uint to_submit,
+                       const uint min_complete, const uint flags) {
+  return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                      NULL, 0);
+}
+
+// Sets up a ring and registers the buffers of a pipeline with it.
+//
+// @returns false if io_uring is unavailable.
+static bool uring_init(struct pipeline *const pipeline) {
+  struct uring *const ring = &pipeline->ring;
+  struct io_uring_params params;
+
+  memset(&params, 0, sizeof(params));
+  ring->fd = (int)syscall(__NR_io_uring_setup, PIPELINE_BUFS_NUM, &params);
+
+  if (ring->fd < 0) {
+    ring->fd = -1;
+    return false;
+  }
+
+  // Plain writes to an offset came along with reads and writes at the current
+  // file position.
+  if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+    close(ring->fd);
+    ring->fd = -1;
+    return false;
+  }
+
+  ring->sq_map_size = params.sq_off.array + (params.sq_entries * sizeof(u32));
+  ring->cq_map_size =
+      params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    if (ring->cq_map_size > ring->sq_map_size) {
+      ring->sq_map_size = ring->cq_map_size;
+    }
+    ring->cq_map_size = 0;
+  }
+
+  ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  ring->cq_map = ring->sq_map;
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = MAP_FAILED;
+
+  if ((ring->sq_map != MAP_FAILED) && (ring->cq_map_size != 0)) {
+    ring->cq_map =
+        mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+  }
+
+  if ((ring->sq_map != MAP_FAILED) && (ring->cq_map != MAP_FAILED)) {
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  }
+
+  if (ring->sqes == MAP_FAILED) {
+    if ((ring->cq_map != ring->sq_map) && (ring->cq_map != MAP_FAILED)) {
+      munmap(ring->cq_map, ring->cq_map_size);
+    }
+
+    if (ring->sq_map != MAP_FAILED) {
+      munmap(ring->sq_map, ring->sq_map_size);
+    }
+    close(ring->fd);
+    ring->fd = -1;
+    return false;
+  }
+
+  u8 *const sq = ring->sq_map;
+  u8 *const cq = ring->cq_map;
+
+  ring->sq_head = (u32 *)(void *)(sq + params.sq_off.head);
+  ring->sq_tail = (u32 *)(void *)(sq + params.sq_off.tail);
+  ring->sq_mask = (u32 *)(void *)(sq + params.sq_off.ring_mask);
+  ring->sq_array = (u32 *)(void *)(sq + params.sq_off.array);
+  ring->cq_head = (u32 *)(void *)(cq + params.cq_off.head);
+  ring->cq_tail = (u32 *)(void *)(cq + params.cq_off.tail);
+  ring->cq_mask = (u32 *)(void *)(cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *)(void *)(cq + params.cq_off.cqes);
+
+  // Registered buffers are pinned once, rather than on every write. Without
+  // them, such as over the locked memory limit, writes still work.
+  struct iovec iovs[PIPELINE_BUFS_NUM];
+
+  for (size_t i = 0; i < PIPELINE_BUFS_NUM; ++i) {
+    iovs[i].iov_base = pipeline->bufs[i].data;
+    iovs[i].iov_len = PIPELINE_BUF_SIZE;
+  }
+
+  ring->fixed = syscall(__NR_io_uring_register, ring->fd,
+                        IORING_REGISTER_BUFFERS, iovs, PIPELINE_BUFS_NUM) == 0;
+  return true;
+}
+
+// Tears down the ring of a pipeline.
+static void uring_destroy(struct uring *const ring) {
+  if (ring->fd == -1) {
+    return;
+  }
+
+  munmap(ring->sqes, ring->sqes_size);
+
+  if (ring->cq_map != ring->sq_map) {
+    munmap(ring->cq_map, ring->cq_map_size);
+  }
+  munmap(ring->sq_map, ring->sq_map_size);
+  close(ring->fd);
+}
+
+// Waits for at least one write submitted through the ring to complete, and
+// handles every completion.
+static void uring_reap(struct pipeline *const pipeline) {
+  struct uring *const ring = &pipeline->ring;
+
+  for (;;) {
+    u32 head = *ring->cq_head;
+    const u32 tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    if (head != tail) {
+      for (; head != tail; ++head) {
+        const struct io_uring_cqe *const cqe =
+            &ring->cqes[head & *ring->cq_mask];
+
+        buf_complete(pipeline, (size_t)cqe->user_data, cqe->res);
+      }
+      __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+      return;
+    }
+
+    if ((uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0) &&
+        (errno != EINTR)) {
+      // The ring is unusable; nothing in flight will ever complete.
+      const int err = errno;
+
+      for (size_t i = 0; i < PIPELINE_BUFS_NUM; ++i) {
+        if (pipeline->bufs[i].in_flight) {
+          buf_complete(pipeline, i, -err);
+        }
+      }
+      return;
+    }
+  }
+}
+
+// Determines whether a write other than that of a buffer is in flight.
+static bool others_in_flight(const struct pipeline *const pipeline,
+                             const size_t index) {
+  for (size_t i = 0; i < PIPELINE_BUFS_NUM; ++i) {
+    if ((i != index) && pipeline->bufs[i].in_flight) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Submits the write of a buffer through the ring.
+//
+// @returns 0 on success, or a negated error number if it was not submitted.
+//          -EAGAIN and -EBUSY mean the ring was short of resources with no
+//          other write in flight to free them.
+static int uring_submit(struct pipeline *const pipeline, const size_t index) {
+  struct uring *const ring = &pipeline->ring;
+  const struct pipeline_buf *const buf = &pipeline->bufs[index];
+
+  // Only as many writes as there are buffers are ever in flight, and the ring
+  // has an entry for each, so there is always room.
+  const u32 tail = *ring->sq_tail;
+  const u32 slot = tail & *ring->sq_mask;
+  struct io_uring_sqe *const sqe = &ring->sqes[slot];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = ring->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  sqe->fd = pipeline->files[buf->file].fd;
+  sqe->addr = (u64)(uintptr_t)buf->data;
+  sqe->len = (u32)buf->write_len;
+  sqe->off = (u64)buf->offset;
+  sqe->buf_index = ring->fixed ? (u16)index : 0;
+  sqe->user_data = index;
+
+  ring->sq_array[slot] = slot;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  for (;;) {
+    if (uring_enter(ring->fd, 1, 0, 0) >= 0) {
+      return 0;
+    }
+
+    if (errno == EINTR) {
+      continue;
+    }
+
+    if ((errno != EAGAIN) && (errno != EBUSY)) {
+      return -errno;
+    }
+
+    // Short of resources until completions are handled, which only another
+    // write in flight can provide.
+    if (others_in_flight(pipeline, index)) {
+      uring_reap(pipeline);
+      continue;
+    }
+
+    const int err = errno;
+
+    // Take the entry back, unless the kernel consumed it after all.
+    if (__atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) != tail) {
+      return 0;
+    }
+    *ring->sq_tail = tail;
+    return -err;
+  }
+}
+#endif  // PIPELINE_HAVE_URING
+
+// Waits until a buffer is no longer being written out.
+static void buf_wait(struct pipeline *const pipeline, const size_t index) {
+  while (pipeline->bufs[index].in_flight) {
+#ifdef PIPELINE_HAVE_URING
+    uring_reap(pipeline);
+#endif  // PIPELINE_HAVE_URING
+  }
+}
+
+// Submits the write of the buffer being filled, and moves on to the next.
+static void buf_submit(struct pipeline *const pipeline) {
+  const size_t index = pipeline->cur;
+  struct pipeline_buf *const buf = &pipeline->bufs[index];
+  struct pipeline_file *const file = &pipeline->files[buf->file];
+
+  pipeline->cur = (index + 1) % PIPELINE_BUFS_NUM;
+
+  if (buf->len == 0) {
+    return;
+  }
+
+  buf->write_len = buf->len;
+
+  if (file->direct) {
+    const size_t padded = (buf->len + PIPELINE_DIRECT_ALIGN - 1) &
+                          ~(size_t)(PIPELINE_DIRECT_ALIGN - 1);
+
+    memset(&buf->data[buf->len], 0, padded - buf->len);
+    buf->write_len = padded;
+  }
+
+  file->size += buf->len;
+  file->pending++;
+  buf->in_flight = true;
+
+#ifdef PIPELINE_HAVE_URING
+  if (pipeline->backend == PIPELINE_BACKEND_URING) {
+    const int err = uring_submit(pipeline, index);
+
+    if (err == 0) {
+      return;
+    }
+
+    // Waiting for the ring to free resources could take forever with nothing
+    // else in flight, so only this buffer is written with pwrite(). Other
+    // errors leave the ring unusable: writes already in flight still complete
+    // through it, but no more are submitted to it.
+    if ((err != -EAGAIN) && (err != -EBUSY)) {
+      pipeline->backend = PIPELINE_BACKEND_PWRITE;
+    }
+  }
+#endif  // PIPELINE_HAVE_URING
+
+  buf_complete(pipeline, index,
+               pwrite_all(file->fd, buf->data, buf->write_len, buf->offset));
+}
+
+// Starts filling the next buffer, once its previous write completed.
+static void buf_start(struct pipeline *const pipeline) {
+  struct pipeline_buf *const buf = &pipeline->bufs[pipeline->cur];
+
+  buf_wait(pipeline, pipeline->cur);
+
+  buf->len = 0;
+  buf->file = pipeline->file;
+  buf->offset = (off_t)pipeline->files[pipeline->file].size;
+}
+
+struct pipeline *pipeline_create(const enum pipeline_backend backend,
+                                 const bool direct) {
+  struct pipeline *const pipeline = calloc(1, sizeof(*pipeline));
+
+  if (pipeline == NULL) {
+    return NULL;
+  }
+
+  pipeline->backend = PIPELINE_BACKEND_PWRITE;
+  pipeline->direct = direct;
+  pipeline->file = PIPELINE_FILES_NUM;
+
+  for (size_t i = 0; i < PIPELINE_FILES_NUM; ++i) {
+    pipeline->files[i].fd = -1;
+  }
+
+  for (size_t i = 0; i < PIPELINE_BUFS_NUM; ++i) {
+    pipeline->bufs[i].data =
+        aligned_alloc(PIPELINE_DIRECT_ALIGN, PIPELINE_BUF_SIZE);
+
+    if (pipeline->bufs[i].data == NULL) {
+      pipeline_destroy(pipeline);
+      return NULL;
+    }
+  }
+
+#ifdef PIPELINE_HAVE_URING
+  pipeline->ring.fd = -1;
+
+  if ((backend == PIPELINE_BACKEND_URING) && uring_init(pipeline)) {
+    pipeline->backend = PIPELINE_BACKEND_URING;
+  }
+#else
+  (void)backend;
+#endif  // PIPELINE_HAVE_URING
+
+  return pipeline;
+}
+
+enum pipeline_backend pipeline_backend_get(
+    const struct pipeline *const pipeline) {
+  return pipeline->backend;
+}
+
+bool pipeline_open(struct pipeline *const pipeline, const char *const path,
+                   const size_t size, bool *const failed) {
+  // Finished files stay open only while a buffer is still being written out
+  // to them, and there is one more slot than there are buffers.
+  size_t slot = 0;
+
+  while (pipeline->files[slot].fd != -1) {
+    slot++;
+  }
+
+  const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  bool direct = pipeline->direct;
+  int fd = open(path, flags | (direct ? O_DIRECT : 0), 0666);
+
+  // Not every file system supports O_DIRECT.
+  if ((fd == -1) && direct && (errno == EINVAL)) {
+    direct = false;
+    fd = open(path, flags, 0666);
+  }
+
+  if (fd == -1) {
+    *failed = true;
+    return false;
+  }
+
+  // Allocating the whole file up front lets the file system lay it out in one
+  // piece; not every file system can, which only costs performance.
+  const int err = posix_fallocate(fd, 0, (off_t)size);
+
+  if ((err != 0) && (err != EINVAL) && (err != EOPNOTSUPP)) {
+    close(fd);
+    *failed = true;
+    return false;
+  }
+
+  pipeline->files[slot] = (struct pipeline_file){
+      .fd = fd, .open = true, .direct = direct, .failed_out = failed};
+  pipeline->file = slot;
+
+  buf_start(pipeline);
+  return true;
+}
+
+void pipeline_write(struct pipeline *const pipeline, const void *const src,
+                    size_t size) {
+  const u8 *bytes = src;
+
+  while (size != 0) {
+    struct pipeline_buf *const buf = &pipeline->bufs[pipeline->cur];
+    const size_t space = PIPELINE_BUF_SIZE - buf->len;
+    const size_t num = (size < space) ? size : space;
+
+    memcpy(&buf->data[buf->len], bytes, num);
+    buf->len += num;
+    bytes += num;
+    size -= num;
+
+    if (buf->len == PIPELINE_BUF_SIZE) {
+      buf_submit(pipeline);
+      buf_start(pipeline);
+    }
+  }
+}
+
+void *pipeline_span_get(struct pipeline *const pipeline,
+                        size_t *const size) {
+  struct pipeline_buf *buf = &pipeline->bufs[pipeline->cur];
+
+  // Bytes written by pipeline_write() can leave the buffer an odd number of
+  // bytes short of full.
+  if ((PIPELINE_BUF_SIZE - buf->len) < sizeof(s16)) {
+    buf_submit(pipeline);
+    buf_start(pipeline);
+    buf = &pipeline->bufs[pipeline->cur];
+  }
+
+  *size = PIPELINE_BUF_SIZE - buf->len;
+  return &buf->data[buf->len];
+}
+
+void pipeline_span_put(struct pipeline *const pipeline, const size_t size) {
+  struct pipeline_buf *const buf = &pipeline->bufs[pipeline->cur];
+
+  buf->len += size;
+
+  if (buf->len == PIPELINE_BUF_SIZE) {
+    buf_submit(pipeline);
+    buf_start(pipeline);
+  }
+}
+
+void pipeline_close(struct pipeline *const pipeline) {
+  struct pipeline_file *const file = &pipeline->files[pipeline->file];
+
+  buf_submit(pipeline);
+
+  file->open = false;
+  file_finish(file);
+  pipeline->file = PIPELINE_FILES_NUM;
+}
+
+void pipeline_destroy(struct pipeline *const pipeline) {
+  if (pipeline == NULL) {
+    return;
+  }
+
+  for (size_t i = 0; i < PIPELINE_BUFS_NUM; ++i) {
+    buf_wait(pipeline, i);
+  }
+
+#ifdef PIPELINE_HAVE_URING
+  uring_destroy(&pipeline->ring);
+#endif  // PIPELINE_HAVE_URING
+
+  for (size_t i = 0; i < PIPELINE_BUFS_NUM; ++i) {
+    free(pipeline->bufs[i].data);
+  }
+  free(pipeline);
+}
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The output pipeline of same-render, which writes files through a small ring
+// of buffers.
+//
+// Samples are stored into one buffer while the buffers filled before it are
+// still being written out, so rendering the next block of a message overlaps
+// writing the last. Writes are submitted through io_uring where the kernel
+// supports it, into buffers registered with the ring up front, and with plain
+// pwrite() calls otherwise.
+//
+// A pipeline is not thread-safe; every rendering thread uses one of its own.
+
+#ifndef SAME_RENDER_PIPELINE_H
+#define SAME_RENDER_PIPELINE_H
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libsame/types.h"
+
+// The number of buffers a pipeline cycles through.
+#define PIPELINE_BUFS_NUM (3)
+
+// The number of bytes in each buffer.
+#define PIPELINE_BUF_SIZE (256 * 1024)
+
+// The alignment O_DIRECT requires of buffers, file offsets and write lengths.
+#define PIPELINE_DIRECT_ALIGN (4096)
+
+// The ways a pipeline can write its buffers out.
+enum pipeline_backend { PIPELINE_BACKEND_URING, PIPELINE_BACKEND_PWRITE };
+
+// A pipeline; its members are private to pipeline.c.
+struct pipeline;
+
+// Creates a pipeline.
+//
+// @param backend The backend to write with. io_uring falls back to pwrite()
+//                if the kernel does not support it.
+// @param direct Whether to bypass the page cache with O_DIRECT, on file
+//               systems which support it.
+// @returns The pipeline, or NULL if out of memory.
+struct pipeline *pipeline_create(enum pipeline_backend backend, bool direct);
+
+// Retrieves the backend a pipeline ended up writing with.
+enum pipeline_backend pipeline_backend_get(const struct pipeline *pipeline);
+
+// Creates a file and makes it the one the pipeline writes to.
+//
+// The file is closed by pipeline_close(), once its last write completes.
+//
+// @param path The path of the file.
+// @param size The final size of the file in bytes, which it is allocated with
+//             up front.
+// @param failed Set to true if writing the file fails, which may only be found
+//               out after pipeline_close().
+// @returns false if the file could not be created.
+bool pipeline_open(struct pipeline *pipeline, const char *path, size_t size,
+                   bool *failed);
+
+// Appends bytes to the file being written.
+void pipeline_write(struct pipeline *pipeline, const void *src, size_t size);
+
+// Retrieves the free part of the buffer being filled, such that bytes can be
+// appended to the file by storing them there directly.
+//
+// @param size Where to store the number of bytes free, which is at least two.
+// @returns Where to store the bytes.
+void *pipeline_span_get(struct pipeline *pipeline, size_t *size);
+
+// Appends the bytes stored into the span pipeline_span_get() returned to the
+// file being written.
+//
+// @param size The number of bytes stored.
+void pipeline_span_put(struct pipeline *pipeline, size_t size);
+
+// Finishes the file being written. Its last writes are submitted, but not
+// waited for.
+void pipeline_close(struct pipeline *pipeline);
+
+// Waits for every write of a pipeline to complete, closes every file and
+// destroys the pipeline.
+void pipeline_destroy(struct pipeline *pipeline);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // SAME_RENDER_PIPELINE_H
@@ -0,0 +1,652 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2024 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// same-render renders SAME messages in bulk, from a file of headers to one WAV
+// or raw PCM file per message.
+//
+// Headers are read from a CSV file with the columns
+//
+//     originator_code,event_code,location_codes,valid_time_period,
+//     originator_time,callsign,attn_sig_duration
+//
+// where the location codes are separated by dashes as they are in a SAME
+// header, or from a JSON-lines file with one object per line, keyed by the
+// member names of struct libsame_header and with location_codes as an array
+// of strings. Blank lines and lines starting with '#' are skipped, as is a CSV
+// line naming the columns ahead of the first header.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "header_parse.h"
+#include "libsame/libsame.h"
+#include "pipeline.h"
+
+// The number of bytes one rendered sample takes up in an output file.
+#define SAMPLE_SIZE (2)
+
+// The formats headers can be read from.
+enum input_fmt { INPUT_FMT_CSV, INPUT_FMT_JSONL };
+
+// The formats messages can be written in.
+enum output_fmt { OUTPUT_FMT_WAV, OUTPUT_FMT_RAW };
+
+// The ways messages can be written to their files.
+enum output_method {
+  // Rendered straight into a mapping of the file; WAV files only.
+  OUTPUT_METHOD_MMAP,
+
+  // Written through an io_uring output pipeline.
+  OUTPUT_METHOD_URING,
+
+  // Written through an output pipeline using pwrite().
+  OUTPUT_METHOD_PWRITE
+};
+
+// The names of the output methods, as given on the command line.
+static const char *const OUTPUT_METHOD_NAMES[] = {
+    [OUTPUT_METHOD_MMAP] = "mmap",
+    [OUTPUT_METHOD_URING] = "uring",
+    [OUTPUT_METHOD_PWRITE] = "pwrite"};
+
+// The output file of one message.
+struct output {
+  // The mapping of the WAV file, while the message is being rendered into it.
+  void *map;
+
+  // The size of the mapping.
+  size_t map_size;
+
+  // The number of samples in the message, calculated before rendering.
+  size_t samples_num;
+
+  // The number of samples written so far.
+  size_t written;
+
+  // Whether the file is being written through an output pipeline.
+  bool opened;
+
+  // Whether writing the message failed.
+  bool failed;
+
+  // Pads the flags up to the alignment of the sample counts.
+  u8 padding[sizeof(size_t) - (2 * sizeof(bool))];
+};
+
+// Everything the sink needs to write the rendered messages.
+struct render {
+  // The output file of every message.
+  struct output *outputs;
+
+  // The directory to write the output files to.
+  const char *dir;
+
+  // The sample rate the messages are rendered at.
+  uint sample_rate;
+
+  // The format to write the messages in.
+  enum output_fmt fmt;
+
+  // The way to write the messages to their files.
+  enum output_method method;
+
+  // Whether output pipelines bypass the page cache.
+  bool direct;
+
+  // Pads the flag up to the alignment of the sample rate.
+  u8 padding[sizeof(uint) - sizeof(bool)];
+};
+
+// The output pipeline of the calling rendering thread, created on first use.
+static _Thread_local struct pipeline *thread_pipeline;
+
+// Every output pipeline created, to be drained and destroyed once rendering
+// is done.
+static struct pipeline *pipelines[LIBSAME_BULK_THREADS_MAX];
+
+// The number of output pipelines created.
+static size_t pipelines_num;
+
+// The headers being parsed from an input file.
+struct headers {
+  // The headers parsed so far.
+  struct libsame_header *headers;
+
+  // The number of headers parsed so far.
+  size_t num;
+
+  // The number of headers the array can hold.
+  size_t cap;
+};
+
+// Prints the usage of the program.
+static void usage_print(FILE *const stream, const char *const argv0) {
+  fprintf(stream,
+          "usage: %s [-r RATE] [-f wav|raw] [-o mmap|uring|pwrite] [-d] "
+          "[-t csv|jsonl]\n"
+          "          [-j THREADS] INPUT OUTPUT_DIR\n\n"
+          "Renders one SAME message per header in INPUT into OUTPUT_DIR.\n\n"
+          "  -r RATE     sample rate in Hz, 8000 to 96000 (default: 48000)\n"
+          "  -f FORMAT   output format, 16-bit mono WAV or raw little-endian "
+          "PCM\n"
+          "              (default: wav)\n"
+          "  -o METHOD   how files are written: rendered into a memory mapping "
+          "(WAV\n"
+          "              only), or through a pipeline of buffers written with "
+          "io_uring\n"
+          "              or pwrite() (default: mmap for WAV, uring for raw; "
+          "uring\n"
+          "              falls back to pwrite if the kernel lacks it)\n"
+          "  -d          bypass the page cache with O_DIRECT (uring and pwrite "
+          "only)\n"
+          "  -t TYPE     input type (default: csv if INPUT ends in .csv, "
+          "jsonl\n"
+          "              otherwise)\n"
+          "  -j THREADS  number of rendering threads (default: one per online "
+          "CPU)\n"
+          "  -h          print this help and exit\n",
+          argv0);
+}
+
+// Reads every header from an input file.
+//
+// @returns false if the file could not be read or a header is malformed.
+static bool headers_read(struct headers *const headers,
+                         const char *const path, const enum input_fmt fmt) {
+  FILE *const file = fopen(path, "r");
+
+  if (file == NULL) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  char *line = NULL;
+  size_t line_cap = 0;
+  size_t line_num = 0;
+  ssize_t len;
+  bool ok = true;
+
+  // Only the first line that is neither blank nor a comment can name the CSV
+  // columns.
+  bool columns_allowed = fmt == INPUT_FMT_CSV;
+
+  while (ok && ((len = getline(&line, &line_cap, file)) != -1)) {
+    line_num++;
+
+    while ((len > 0) && ((line[len - 1] == '\n') || (line[len - 1] == '\r'))) {
+      line[--len] = '\0';
+    }
+
+    if ((len == 0) || (line[0] == '#')) {
+      continue;
+    }
+
+    const bool columns = columns_allowed && header_parse_csv_columns(line);
+
+    columns_allowed = false;
+
+    if (columns) {
+      continue;
+    }
+
+    if (headers->num == headers->cap) {
+      const size_t cap = (headers->cap != 0) ? (headers->cap * 2) : 256;
+      struct libsame_header *const grown =
+          realloc(headers->headers, cap * sizeof(*grown));
+
+      if (grown == NULL) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        ok = false;
+        break;
+      }
+      headers->headers = grown;
+      headers->cap = cap;
+    }
+
+    struct libsame_header *const header = &headers->headers[headers->num];
+    memset(header, 0, sizeof(*header));
+
+    const char *const err = (fmt == INPUT_FMT_CSV)
+                                ? header_parse_csv(header, line)
+                                : header_parse_jsonl(header, line);
+
+    if (err != NULL) {
+      fprintf(stderr, "%s:%zu: %s\n", path, line_num, err);
+      ok = false;
+    }
+    headers->num++;
+  }
+
+  if (ok && ferror(file)) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    ok = false;
+  }
+
+  free(line);
+  fclose(file);
+
+  return ok;
+}
+
+// Formats the path of the output file of a message.
+static void output_path_get(const struct render *const render,
+                            const size_t msg, char *const path,
+                            const size_t size) {
+  snprintf(path, size, "%s/%06zu.%s", render->dir, msg,
+           (render->fmt == OUTPUT_FMT_WAV) ? "wav" : "raw");
+}
+
+// Retrieves the output pipeline of the calling rendering thread, creating it
+// on first use.
+static struct pipeline *thread_pipeline_get(const struct render *const render) {
+  if (thread_pipeline == NULL) {
+    thread_pipeline = pipeline_create((render->method == OUTPUT_METHOD_URING)
+                                          ? PIPELINE_BACKEND_URING
+                                          : PIPELINE_BACKEND_PWRITE,
+                                      render->direct);
+
+    if (thread_pipeline != NULL) {
+      pipelines[__atomic_fetch_add(&pipelines_num, 1, __ATOMIC_RELAXED)] =
+          thread_pipeline;
+    }
+  }
+  return thread_pipeline;
+}
+
+// Maps the WAV output file of a message, created at its final size, for the
+// bulk renderer to render the message straight into.
+static void *sink_wav_map(void *const userdata, const size_t msg,
+                          const size_t size) {
+  const struct render *const render = userdata;
+  struct output *const out = &render->outputs[msg];
+  char path[4096];
+
+  output_path_get(render, msg, path, sizeof(path));
+
+  const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+  if (fd == -1) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    out->failed = true;
+    return NULL;
+  }
+
+  // Not every file system can preallocate, which only costs performance as
+  // long as the file still gets its final size. Where it can, a full disk
+  // fails here rather than while the mapping is written to.
+  int err = posix_fallocate(fd, 0, (off_t)size);
+
+  if ((err == EINVAL) || (err == EOPNOTSUPP)) {
+    err = (ftruncate(fd, (off_t)size) == 0) ? 0 : errno;
+  }
+
+  void *const map = (err == 0) ? mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                      MAP_SHARED, fd, 0)
+                               : MAP_FAILED;
+
+  if ((err == 0) && (map == MAP_FAILED)) {
+    err = errno;
+  }
+
+  // The mapping keeps the file open.
+  close(fd);
+
+  if (err != 0) {
+    fprintf(stderr, "%s: %s\n", path, strerror(err));
+    out->failed = true;
+    return NULL;
+  }
+
+  out->map = map;
+  out->map_size = size;
+
+  return map;
+}
+
+// Provides the bulk renderer with the free part of the buffer of the output
+// pipeline of the thread, opening the output file at the start of a message,
+// such that samples are generated straight into it.
+static void *sink_span_get(void *const userdata, const size_t msg,
+                           size_t *const size) {
+  const struct render *const render = userdata;
+  struct output *const out = &render->outputs[msg];
+  struct pipeline *const pipeline = thread_pipeline_get(render);
+
+  if (pipeline == NULL) {
+    out->failed = true;
+  }
+
+  if (!out->opened && !out->failed) {
+    const bool wav = render->fmt == OUTPUT_FMT_WAV;
+    const size_t file_size =
+        (wav ? LIBSAME_WAV_HEADER_SIZE : 0) + (out->samples_num * SAMPLE_SIZE);
+    char path[4096];
+
+    output_path_get(render, msg, path, sizeof(path));
+
+    if (!pipeline_open(pipeline, path, file_size, &out->failed)) {
+      fprintf(stderr, "%s: %s\n", path, strerror(errno));
+      return NULL;
+    }
+    out->opened = true;
+
+    if (wav) {
+      u8 header[LIBSAME_WAV_HEADER_SIZE];
+
+      libsame_wav_header_store(header, render->sample_rate, out->samples_num);
+      pipeline_write(pipeline, header, sizeof(header));
+    }
+  }
+
+  if (!out->opened) {
+    return NULL;
+  }
+  return pipeline_span_get(pipeline, size);
+}
+
+// Appends the samples the bulk renderer generated into the span
+// sink_span_get() provided to the output file.
+static void sink_span_put(void *const userdata, const size_t msg,
+                          const size_t size) {
+  const struct render *const render = userdata;
+
+  pipeline_span_put(thread_pipeline, size);
+  render->outputs[msg].written += size / SAMPLE_SIZE;
+}
+
+// Finishes the output file of a message once the bulk renderer is done with
+// it.
+static void sink_done(void *const userdata, const size_t msg,
+                      const size_t samples_num) {
+  const struct render *const render = userdata;
+  struct output *const out = &render->outputs[msg];
+
+  if (out->map != NULL) {
+    if (munmap(out->map, out->map_size) != 0) {
+      out->failed = true;
+    }
+    out->map = NULL;
+    out->written = samples_num;
+  }
+
+  // Writes still in flight report failures once they complete.
+  if (out->opened) {
+    pipeline_close(thread_pipeline);
+  }
+
+  if ((samples_num != out->samples_num) || (out->written != samples_num)) {
+    out->failed = true;
+  }
+}
+
+// Retrieves the time of a monotonic clock in seconds.
+static double time_get(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+// Parses a whole decimal number given on the command line.
+//
+// @returns false if the string is not a number, or it is out of range.
+static bool num_parse(const char *const str, const long min, const long max,
+                      long *const num) {
+  char *end;
+
+  errno = 0;
+  const long value = strtol(str, &end, 10);
+
+  if ((end == str) || (*end != '\0') || (errno != 0) || (value < min) ||
+      (value > max)) {
+    return false;
+  }
+  *num = value;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  uint sample_rate = 48000;
+  enum output_fmt output_fmt = OUTPUT_FMT_WAV;
+  int output_method = -1;
+  bool direct = false;
+  int input_fmt = -1;
+  long threads_num = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:f:o:dt:j:h")) != -1) {
+    switch (opt) {
+      case 'r': {
+        long rate;
+
+        if (!num_parse(optarg, LIBSAME_SAMPLE_RATE_MIN,
+                       LIBSAME_SAMPLE_RATE_MAX, &rate)) {
+          fprintf(stderr, "The sample rate must be %u to %u Hz.\n",
+                  LIBSAME_SAMPLE_RATE_MIN, LIBSAME_SAMPLE_RATE_MAX);
+          usage_print(stderr, argv[0]);
+          return EXIT_FAILURE;
+        }
+        sample_rate = (uint)rate;
+        break;
+      }
+
+      case 'f':
+        if (strcmp(optarg, "wav") == 0) {
+          output_fmt = OUTPUT_FMT_WAV;
+        } else if (strcmp(optarg, "raw") == 0) {
+          output_fmt = OUTPUT_FMT_RAW;
+        } else {
+          usage_print(stderr, argv[0]);
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'o':
+        output_method = -1;
+
+        for (size_t i = 0; i < (sizeof(OUTPUT_METHOD_NAMES) /
+                                sizeof(OUTPUT_METHOD_NAMES[0]));
+             ++i) {
+          if (strcmp(optarg, OUTPUT_METHOD_NAMES[i]) == 0) {
+            output_method = (int)i;
+          }
+        }
+
+        if (output_method == -1) {
+          usage_print(stderr, argv[0]);
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'd':
+        direct = true;
+        break;
+
+      case 't':
+        if (strcmp(optarg, "csv") == 0) {
+          input_fmt = INPUT_FMT_CSV;
+        } else if (strcmp(optarg, "jsonl") == 0) {
+          input_fmt = INPUT_FMT_JSONL;
+        } else {
+          usage_print(stderr, argv[0]);
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'j':
+        // More threads than the bulk renderer runs are clamped below.
+        if (!num_parse(optarg, 1, LONG_MAX, &threads_num)) {
+          usage_print(stderr, argv[0]);
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'h':
+        usage_print(stdout, argv[0]);
+        return EXIT_SUCCESS;
+
+      default:
+        usage_print(stderr, argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  if ((argc - optind) != 2) {
+    usage_print(stderr, argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const char *const input = argv[optind];
+  const char *const dir = argv[optind + 1];
+
+  if (output_method == -1) {
+    output_method = (output_fmt == OUTPUT_FMT_WAV) ? OUTPUT_METHOD_MMAP
+                                                   : OUTPUT_METHOD_URING;
+  } else if ((output_method == OUTPUT_METHOD_MMAP) &&
+             (output_fmt != OUTPUT_FMT_WAV)) {
+    fprintf(stderr, "Only WAV files can be written through a mapping.\n");
+    return EXIT_FAILURE;
+  }
+
+  if (direct && (output_method == OUTPUT_METHOD_MMAP)) {
+    fprintf(stderr, "O_DIRECT needs the uring or pwrite output method.\n");
+    return EXIT_FAILURE;
+  }
+
+  if (threads_num < 1) {
+    threads_num = 1;
+  } else if (threads_num > LIBSAME_BULK_THREADS_MAX) {
+    threads_num = LIBSAME_BULK_THREADS_MAX;
+  }
+
+  if (input_fmt == -1) {
+    const size_t len = strlen(input);
+
+    input_fmt = ((len >= 4) && (strcmp(&input[len - 4], ".csv") == 0))
+                    ? INPUT_FMT_CSV
+                    : INPUT_FMT_JSONL;
+  }
+
+  struct headers headers = {0};
+
+  if (!headers_read(&headers, input, (enum input_fmt)input_fmt)) {
+    free(headers.headers);
+    return EXIT_FAILURE;
+  }
+
+  if ((mkdir(dir, 0777) != 0) && (errno != EEXIST)) {
+    fprintf(stderr, "%s: %s\n", dir, strerror(errno));
+    free(headers.headers);
+    return EXIT_FAILURE;
+  }
+
+  libsame_init();
+
+  // The length of every message is known before it is rendered, which lets
+  // each output file be sized in one go.
+  struct render render = {.outputs = calloc(headers.num, sizeof(struct output)),
+                          .dir = dir,
+                          .sample_rate = sample_rate,
+                          .fmt = output_fmt,
+                          .method = (enum output_method)output_method,
+                          .direct = direct};
+
+  if ((render.outputs == NULL) && (headers.num != 0)) {
+    fprintf(stderr, "Out of memory.\n");
+    free(headers.headers);
+    return EXIT_FAILURE;
+  }
+
+  for (size_t i = 0; i < headers.num; ++i) {
+    struct libsame_segment_map map;
+
+    libsame_segment_map_get(&map, &headers.headers[i], sample_rate);
+    render.outputs[i].samples_num = map.samples_num;
+  }
+
+  // Mapped files are rendered into directly; otherwise, samples are generated
+  // into the buffers of the output pipeline.
+  const bool mapped = output_method == OUTPUT_METHOD_MMAP;
+  const struct libsame_bulk_sink sink = {
+      .write = NULL,
+      .done = sink_done,
+      .wav_map = mapped ? sink_wav_map : NULL,
+      .span_get = mapped ? NULL : sink_span_get,
+      .span_put = mapped ? NULL : sink_span_put,
+      .userdata = &render};
+
+  const double start = time_get();
+  const size_t samples_num = libsame_bulk_render(
+      headers.headers, headers.num, sample_rate, &sink, (uint)threads_num);
+
+  // The last writes of every pipeline are still in flight.
+  bool fell_back = false;
+
+  for (size_t i = 0; i < pipelines_num; ++i) {
+    if (pipeline_backend_get(pipelines[i]) == PIPELINE_BACKEND_PWRITE) {
+      fell_back = true;
+    }
+    pipeline_destroy(pipelines[i]);
+  }
+
+  const double elapsed = time_get() - start;
+
+  if (fell_back && (output_method == OUTPUT_METHOD_URING)) {
+    fprintf(stderr, "io_uring is unavailable; wrote with pwrite() instead.\n");
+  }
+
+  size_t failed = 0;
+
+  for (size_t i = 0; i < headers.num; ++i) {
+    if (render.outputs[i].failed) {
+      fprintf(stderr, "Failed to write message %zu.\n", i);
+      failed++;
+    }
+  }
+
+  const double audio_secs = (double)samples_num / (double)sample_rate;
+
+  printf("Rendered %zu messages (%zu samples, %.1f s of audio) in %.3f s using "
+         "%ld thread(s) and %s%s output\n",
+         headers.num, samples_num, audio_secs, elapsed, threads_num,
+         OUTPUT_METHOD_NAMES[output_method], direct ? " O_DIRECT" : "");
+
+  if (elapsed > 0) {
+    printf("%.1f messages/s, %.3f M samples/s, %.0fx real time\n",
+           (double)headers.num / elapsed, (double)samples_num / elapsed / 1e6,
+           audio_secs / elapsed);
+  }
+
+  free(render.outputs);
+  free(headers.headers);
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}